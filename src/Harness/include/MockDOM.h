@@ -0,0 +1,481 @@
+//
+//  MockDOM.h
+//  PixiAnimate Harness
+//
+//  Lightweight stand-ins for the Animate document the plugin walks while
+//  publishing: shapes with their fills, strokes, paths and edges, symbol
+//  timelines with their layers and frames, and the services that read them.
+//
+
+#ifndef HARNESS_MOCK_DOM_H_
+#define HARNESS_MOCK_DOM_H_
+
+#include "MockHost.h"
+
+#include "ITimeline.h"
+#include "ILayer.h"
+#include "IFrame.h"
+#include "FrameElement/IFrameDisplayElement.h"
+#include "FrameElement/IShape.h"
+#include "FrameElement/IMovieClip.h"
+#include "FillStyle/ISolidFillStyle.h"
+#include "StrokeStyle/ISolidStrokeStyle.h"
+#include "StrokeStyle/IStrokeWidth.h"
+#include "Service/Shape/IRegionGeneratorService.h"
+#include "Service/Shape/IShapeService.h"
+#include "Service/Shape/IFilledRegion.h"
+#include "Service/Shape/IStrokeGroup.h"
+#include "Service/Shape/IPath.h"
+#include "Service/Shape/IEdge.h"
+#include "Service/Tween/ITweenInfoService.h"
+#include "Utils/DOMTypes.h"
+
+#include <string>
+
+namespace Harness
+{
+	using namespace DOM;
+	using namespace DOM::FrameElement;
+	using namespace DOM::FillStyle;
+	using namespace DOM::StrokeStyle;
+	using namespace DOM::Layer;
+	using namespace DOM::Service::Shape;
+	using namespace DOM::Service::Tween;
+
+
+	class MockEdge : public IEdge, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockEdge, FCM_VERSION)
+			INTERFACE_ENTRY(IEdge)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL GetSegment(DOM::Utils::SEGMENT& segment);
+
+		void SetSegment(const DOM::Utils::SEGMENT& segment);
+
+	private:
+
+		DOM::Utils::SEGMENT m_segment;
+	};
+
+
+	// Edges are added from the end of the last one
+	class MockPath : public IPath, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockPath, FCM_VERSION)
+			INTERFACE_ENTRY(IPath)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL GetEdges(FCM::PIFCMList& pEdgeList);
+
+		MockPath();
+
+		void MoveTo(FCM::Float x, FCM::Float y);
+
+		void LineTo(FCM::Float x, FCM::Float y);
+
+		void CurveTo(FCM::Float controlX, FCM::Float controlY, FCM::Float x, FCM::Float y);
+
+	private:
+
+		void AddEdge(const DOM::Utils::SEGMENT& segment);
+
+		FCM::AutoPtr<FCM::IFCMList> m_pEdges;
+
+		DOM::Utils::POINT2D m_point;
+	};
+
+
+	class MockSolidFillStyle : public ISolidFillStyle, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockSolidFillStyle, FCM_VERSION)
+			INTERFACE_ENTRY(ISolidFillStyle)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL GetColor(DOM::Utils::COLOR& color);
+
+		void SetColor(const DOM::Utils::COLOR& color);
+
+	private:
+
+		DOM::Utils::COLOR m_color;
+	};
+
+
+	// A solid stroke with round caps and joins
+	class MockSolidStrokeStyle : public ISolidStrokeStyle, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockSolidStrokeStyle, FCM_VERSION)
+			INTERFACE_ENTRY(ISolidStrokeStyle)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL GetThickness(FCM::Double& thickness);
+
+		virtual FCM::Result _FCMCALL GetFillStyle(FCM::PIFCMUnknown& pFillStyle);
+
+		virtual FCM::Result _FCMCALL GetJoinStyle(DOM::StrokeStyle::JOIN_STYLE& joinStyle);
+
+		virtual FCM::Result _FCMCALL GetCapStyle(DOM::StrokeStyle::CAP_STYLE& capStyle);
+
+		virtual FCM::Result _FCMCALL GetScaleType(DOM::Utils::ScaleType& scaleType);
+
+		virtual FCM::Result _FCMCALL GetStrokeHinting(FCM::Boolean& strokeHinting);
+
+		virtual FCM::Result _FCMCALL GetStrokeWidth(DOM::StrokeStyle::PIStrokeWidth& pStrokeWidth);
+
+		MockSolidStrokeStyle();
+
+		void SetThickness(FCM::Double thickness);
+
+		void SetFillStyle(FCM::PIFCMUnknown pFillStyle);
+
+	private:
+
+		FCM::Double m_thickness;
+
+		FCM::AutoPtr<FCM::IFCMUnknown> m_pFillStyle;
+	};
+
+
+	class MockFilledRegion : public IFilledRegion, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockFilledRegion, FCM_VERSION)
+			INTERFACE_ENTRY(IFilledRegion)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL GetBoundary(PIPath& pPath);
+
+		virtual FCM::Result _FCMCALL GetHoles(FCM::PIFCMList& pHoleList);
+
+		virtual FCM::Result _FCMCALL GetFillStyle(FCM::PIFCMUnknown& pFillStyle);
+
+		MockFilledRegion();
+
+		void SetBoundary(PIPath pPath);
+
+		void AddHole(PIPath pPath);
+
+		void SetFillStyle(FCM::PIFCMUnknown pFillStyle);
+
+	private:
+
+		FCM::AutoPtr<IPath> m_pBoundary;
+
+		FCM::AutoPtr<FCM::IFCMList> m_pHoles;
+
+		FCM::AutoPtr<FCM::IFCMUnknown> m_pFillStyle;
+	};
+
+
+	class MockStrokeGroup : public IStrokeGroup, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockStrokeGroup, FCM_VERSION)
+			INTERFACE_ENTRY(IStrokeGroup)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL GetStrokeStyle(FCM::PIFCMUnknown& pStrokeStyle);
+
+		virtual FCM::Result _FCMCALL GetPaths(FCM::PIFCMList& pPathList);
+
+		MockStrokeGroup();
+
+		void SetStrokeStyle(FCM::PIFCMUnknown pStrokeStyle);
+
+		void AddPath(PIPath pPath);
+
+	private:
+
+		FCM::AutoPtr<FCM::IFCMUnknown> m_pStrokeStyle;
+
+		FCM::AutoPtr<FCM::IFCMList> m_pPaths;
+	};
+
+
+	// What every element placed on a frame has, and the tweens Animate
+	// would report for it
+	class MockDisplayElement : public IFrameDisplayElement
+	{
+	public:
+
+		virtual FCM::Result _FCMCALL GetDepth(FCM::U_Int32& depth);
+
+		virtual FCM::Result _FCMCALL GetObjectSpaceBounds(DOM::Utils::RECT& rect);
+
+		virtual FCM::Result _FCMCALL GetBounds(DOM::Utils::RECT& rect);
+
+		virtual FCM::Result _FCMCALL GetMatrix(DOM::Utils::MATRIX2D& matrix);
+
+		virtual FCM::Result _FCMCALL GetPivot(DOM::Utils::POINT2D& pivot);
+
+		MockDisplayElement();
+
+		void SetDepth(FCM::U_Int32 depth);
+
+		void SetBounds(const DOM::Utils::RECT& bounds);
+
+		void SetMatrix(const DOM::Utils::MATRIX2D& matrix);
+
+		// A tween dictionary to report for this element
+		void AddTweenInfo(FCM::PIFCMDictionary pTweenInfo);
+
+		FCM::PIFCMList GetTweenInfo() const;
+
+	private:
+
+		FCM::U_Int32 m_depth;
+
+		DOM::Utils::RECT m_bounds;
+
+		DOM::Utils::MATRIX2D m_matrix;
+
+		FCM::AutoPtr<FCM::IFCMList> m_pTweenInfo;
+	};
+
+
+	class MockShape : public MockDisplayElement, public IShape, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_MULTI_INTERFACE_MAP(MockShape, FCM_VERSION)
+			INTERFACE_ENTRY_CUSTOM(IFCMUnknown, IShape)
+			INTERFACE_ENTRY(IShape)
+			INTERFACE_ENTRY(IFrameDisplayElement)
+		END_INTERFACE_MAP
+
+		MockShape();
+
+		void AddFill(PIFilledRegion pFill);
+
+		void AddStroke(PIStrokeGroup pStroke);
+
+		// This shape is the source shape placed with a matrix, for the
+		// similarity test
+		void SetCopyOf(PIShape pSource, const DOM::Utils::MATRIX2D& mapAtoB);
+
+		FCM::PIFCMList GetFills() const;
+
+		FCM::PIFCMList GetStrokes() const;
+
+		PIShape GetSource() const;
+
+		const DOM::Utils::MATRIX2D& GetMapAtoB() const;
+
+	private:
+
+		FCM::AutoPtr<FCM::IFCMList> m_pFills;
+
+		FCM::AutoPtr<FCM::IFCMList> m_pStrokes;
+
+		FCM::AutoPtr<IShape> m_pSource;
+
+		DOM::Utils::MATRIX2D m_mapAtoB;
+	};
+
+
+	class MockMovieClip : public MockDisplayElement, public IMovieClip, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_MULTI_INTERFACE_MAP(MockMovieClip, FCM_VERSION)
+			INTERFACE_ENTRY_CUSTOM(IFCMUnknown, IMovieClip)
+			INTERFACE_ENTRY(IMovieClip)
+			INTERFACE_ENTRY(IFrameDisplayElement)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL GetBlendMode(FCM::BlendMode& blendMode);
+
+		virtual FCM::Result _FCMCALL IsVisible(FCM::Boolean& isVisible);
+
+		virtual FCM::Result _FCMCALL GetName(FCM::StringRep16* ppName);
+
+		void SetName(const std::string& name);
+
+	private:
+
+		std::string m_name;
+	};
+
+
+	class MockFrame : public IFrame, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockFrame, FCM_VERSION)
+			INTERFACE_ENTRY(IFrame)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL GetDuration(FCM::U_Int32& duration);
+
+		virtual FCM::Result _FCMCALL GetFrameElements(FCM::PIFCMList& pFrameElementsList);
+
+		virtual FCM::Result _FCMCALL GetFrameElementsByType(
+			FCM::ConstFCMIID& iid,
+			FCM::PIFCMList& pFrameElementsList);
+
+		virtual FCM::Result _FCMCALL GetStartFrameIndex(FCM::U_Int32& frameIndex);
+
+		virtual FCM::Result _FCMCALL GetLabel(FCM::StringRep16* ppLabel);
+
+		virtual FCM::Result _FCMCALL GetLabelType(DOM::KeyFrameLabelType& labelType);
+
+		virtual FCM::Result _FCMCALL GetScript(FCM::StringRep16* ppScript);
+
+		virtual FCM::Result _FCMCALL GetTween(DOM::PITween& pTween);
+
+		MockFrame();
+
+		void SetFrames(FCM::U_Int32 startFrameIndex, FCM::U_Int32 duration);
+
+		// Elements are listed as display elements, TweenWriter casts them
+		// without querying
+		void AddElement(PIFrameDisplayElement pElement);
+
+	private:
+
+		FCM::U_Int32 m_startFrameIndex;
+
+		FCM::U_Int32 m_duration;
+
+		FCM::AutoPtr<FCM::IFCMList> m_pElements;
+	};
+
+
+	class MockLayer : public ILayer, public ILayerNormal, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_MULTI_INTERFACE_MAP(MockLayer, FCM_VERSION)
+			INTERFACE_ENTRY_CUSTOM(IFCMUnknown, ILayer)
+			INTERFACE_ENTRY(ILayer)
+			INTERFACE_ENTRY(ILayerNormal)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL GetName(FCM::StringRep16* ppName);
+
+		virtual FCM::Result _FCMCALL IsVisible(FCM::Boolean& isVisible);
+
+		virtual FCM::Result _FCMCALL GetParentLayer(PILayer& pParentLayer);
+
+		virtual FCM::Result _FCMCALL GetLayerType(FCM::PIFCMUnknown& pLayerType);
+
+		virtual FCM::Result _FCMCALL GetKeyFrames(FCM::PIFCMList& pKeyFrameList);
+
+		virtual FCM::Result _FCMCALL GetFrameAtIndex(FCM::U_Int32 index, PIFrame& pFrame);
+
+		virtual FCM::Result _FCMCALL GetTotalDuration(FCM::U_Int32& duration);
+
+		MockLayer();
+
+		void SetName(const std::string& name);
+
+		// Key frames are added in order, each starting where the last ended
+		void AddKeyFrame(MockFrame* pFrame, FCM::U_Int32 duration);
+
+	private:
+
+		std::string m_name;
+
+		FCM::U_Int32 m_duration;
+
+		FCM::AutoPtr<FCM::IFCMList> m_pKeyFrames;
+	};
+
+
+	class MockTimeline : public ITimeline, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockTimeline, FCM_VERSION)
+			INTERFACE_ENTRY(ITimeline)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL GetName(FCM::StringRep16* ppName);
+
+		virtual FCM::Result _FCMCALL GetLayers(FCM::PIFCMList& pLayerList);
+
+		virtual FCM::Result _FCMCALL GetMaxFrameCount(FCM::U_Int32& frameCount);
+
+		MockTimeline();
+
+		void SetName(const std::string& name);
+
+		void AddLayer(MockLayer* pLayer);
+
+	private:
+
+		std::string m_name;
+
+		FCM::AutoPtr<FCM::IFCMList> m_pLayers;
+	};
+
+
+	class MockRegionGeneratorService : public IRegionGeneratorService, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockRegionGeneratorService, FCM_VERSION)
+			INTERFACE_ENTRY(IRegionGeneratorService)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL GetFilledRegions(PIShape pShape, FCM::PIFCMList& pFilledRegionList);
+
+		virtual FCM::Result _FCMCALL GetStrokeGroups(PIShape pShape, FCM::PIFCMList& pStrokeGroupList);
+	};
+
+
+	// Shapes are similar when one was made a copy of the other, strokes
+	// become fills with the same paths
+	class MockShapeService : public IShapeService, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockShapeService, FCM_VERSION)
+			INTERFACE_ENTRY(IShapeService)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL ConvertStrokeToFill(PIShape pSrcShape, PIShape& pDstShape);
+
+		virtual FCM::Result _FCMCALL TestShapeSimilarity(
+			PIShape pShapeA,
+			PIShape pShapeB,
+			FCM::Boolean& similar,
+			DOM::Utils::MATRIX2D& mapAtoB);
+	};
+
+
+	class MockTweenInfoService : public ITweenInfoService, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockTweenInfoService, FCM_VERSION)
+			INTERFACE_ENTRY(ITweenInfoService)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL GetFrameTweenInfo(PIFrame pFrame, FCM::PIFCMList& pTweenInfoList);
+
+		virtual FCM::Result _FCMCALL GetElementTweenInfo(
+			FCM::PIFCMCallback pCallback,
+			PIFrameDisplayElement pElement,
+			FCM::PIFCMList& pTweenInfoList);
+
+		virtual FCM::Result _FCMCALL GetShapeTweenInfo(PIFrame pFrame, FCM::PIFCMDictionary& pTweenInfo);
+	};
+
+
+	// Add the services that read the mock document to the host
+	void AddDOMServices(MockHost* pHost);
+};
+
+#endif // HARNESS_MOCK_DOM_H_
@@ -0,0 +1,239 @@
+//
+//  MockHost.h
+//  PixiAnimate Harness
+//
+//  Stands in for Animate when the plugin is loaded outside of it: the
+//  callback the plugin creates its classes and gets its services through,
+//  and the core services every publish uses.
+//
+
+#ifndef HARNESS_MOCK_HOST_H_
+#define HARNESS_MOCK_HOST_H_
+
+#include "FCMPluginInterface.h"
+#include "FCMTypes.h"
+#include "IFCMStringUtils.h"
+#include "IFCMDictionary.h"
+#include "Application/Service/IOutputConsoleService.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Harness
+{
+	// The interface maps name each interface without its namespace
+	using namespace FCM;
+	using namespace Application::Service;
+
+	// Counts the mock objects that are alive
+	FCM::FCMPluginModule& GetMockModule();
+
+	// Create a mock object, it is freed when the last reference taken
+	// through one of its interfaces is released
+	template<class T>
+	T* CreateMock(FCM::PIFCMCallback pCallback)
+	{
+		FCM::FCMObject<T>* pObject = NULL;
+		FCM::IntfImpl_Traits<FCM::FCMObject<T> >::CreateInstance(&GetMockModule(), pCallback, NULL, pObject);
+		return pObject;
+	}
+
+	// Strings handed to the plugin are allocated as Animate does, for it to
+	// free through the memory service
+	FCM::Result ToString16(FCM::CStringRep8 pStrSrc, FCM::StringRep16& pStrDest);
+
+	FCM::Result ToString8(FCM::CStringRep16 pStrSrc, FCM::StringRep8& pStrDest);
+
+
+	class MockCalloc : public FCM::IFCMCalloc, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockCalloc, FCM_VERSION)
+			INTERFACE_ENTRY(IFCMCalloc)
+		END_INTERFACE_MAP
+
+		virtual FCM::PVoid _FCMCALL Alloc(FCM::U_Int32 cb);
+
+		virtual void _FCMCALL Free(FCM::PVoid pv);
+	};
+
+
+	class MockStringUtils : public FCM::IFCMStringUtils, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockStringUtils, FCM_VERSION)
+			INTERFACE_ENTRY(IFCMStringUtils)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL ConvertStringRep8to16(FCM::CStringRep8 pStrSrc, FCM::StringRep16& pStrDest);
+
+		virtual FCM::Result _FCMCALL ConvertStringRep16to8(FCM::CStringRep16 pStrSrc, FCM::StringRep8& pStrDest);
+	};
+
+
+	// Prints what the plugin traces to the publish log
+	class MockConsole : public Application::Service::IOutputConsoleService, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockConsole, FCM_VERSION)
+			INTERFACE_ENTRY(IOutputConsoleService)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL Trace(FCM::CStringRep16 pMessage);
+
+		virtual FCM::Result _FCMCALL Clear();
+
+		MockConsole();
+
+		// Keep the messages instead of printing them
+		void SetQuiet(bool quiet);
+
+		const std::string& GetLog() const;
+
+	private:
+
+		bool m_quiet;
+
+		std::string m_log;
+	};
+
+
+	// A list that holds a reference to each item, handed out as added so
+	// an item can be cast to the interface it was added through
+	class MockList : public FCM::IFCMList, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockList, FCM_VERSION)
+			INTERFACE_ENTRY(IFCMList)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL Count(FCM::U_Int32& count);
+
+		virtual FCM::PIFCMUnknown _FCMCALL operator [](FCM::U_Int32 index);
+
+		MockList();
+
+		~MockList();
+
+		void Add(FCM::PIFCMUnknown pItem);
+
+	private:
+
+		std::vector<FCM::PIFCMUnknown> m_items;
+	};
+
+
+	class MockDictionary : public FCM::IFCMDictionary, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockDictionary, FCM_VERSION)
+			INTERFACE_ENTRY(IFCMDictionary)
+		END_INTERFACE_MAP
+
+		virtual FCM::Result _FCMCALL Add(
+			FCM::CStringRep8 pKey,
+			FCM::FCMDictRecTypeID type,
+			FCM::PVoid value,
+			FCM::U_Int32 valueLen);
+
+		virtual FCM::Result _FCMCALL AddLevel(FCM::CStringRep8 pKey, FCM::PIFCMDictionary& ppDict);
+
+		virtual FCM::Result _FCMCALL Remove(FCM::CStringRep8 pKey);
+
+		virtual FCM::Result _FCMCALL Get(
+			FCM::CStringRep8 pKey,
+			FCM::FCMDictRecTypeID type,
+			FCM::PVoid pValue,
+			FCM::U_Int32& valueLen);
+
+		virtual FCM::Result _FCMCALL Clear();
+
+		virtual FCM::Result _FCMCALL Count(FCM::U_Int32& count);
+
+		virtual FCM::Result _FCMCALL GetNth(
+			FCM::U_Int32 index,
+			FCM::StringRep8& pKey,
+			FCM::FCMDictRecTypeID& type,
+			FCM::U_Int32& valueLen);
+
+		virtual FCM::Result _FCMCALL GetInfo(
+			FCM::CStringRep8 pKey,
+			FCM::FCMDictRecTypeID& type,
+			FCM::U_Int32& valueLen);
+
+		// Shorthands for the values the harness fills in
+		void AddString(const std::string& key, const std::string& value);
+
+		void AddDouble(const std::string& key, FCM::Double value);
+
+		MockDictionary* AddLevel(const std::string& key);
+
+	private:
+
+		struct ENTRY
+		{
+			std::string key;
+			FCM::FCMDictRecTypeID type;
+			std::vector<FCM::Byte> value;
+
+			// Levels are handed out without a reference, as Animate does
+			FCM::AutoPtr<FCM::IFCMDictionary> pLevel;
+		};
+
+		ENTRY* Find(FCM::CStringRep8 pKey);
+
+		std::vector<ENTRY> m_entries;
+	};
+
+
+	// The callback the plugin was booted with
+	class MockHost : public FCM::IFCMCallback, public FCM::FCMObjectBase
+	{
+	public:
+
+		BEGIN_INTERFACE_MAP(MockHost, FCM_VERSION)
+			INTERFACE_ENTRY(IFCMCallback)
+		END_INTERFACE_MAP
+
+		// Classes are created by the plugin's own class factories
+		virtual FCM::Result _FCMCALL CreateInstance(
+			FCM::PIFCMUnknown pUnkOuter,
+			FCM::ConstRefFCMCLSID clsid,
+			FCM::ConstRefFCMIID interfaceID,
+			FCM::PPVoid ppvObj);
+
+		virtual FCM::Result _FCMCALL GetService(
+			const FCM::SRVCID& serviceId,
+			FCM::PIFCMUnknown& pUnknown);
+
+		MockHost();
+
+		void AddService(const FCM::SRVCID& serviceId, FCM::PIFCMUnknown pService);
+
+		MockConsole* GetConsole() const;
+
+		void SetConsole(MockConsole* pConsole);
+
+	private:
+
+		std::vector<std::pair<FCM::SRVCID, FCM::AutoPtr<FCM::IFCMUnknown> > > m_services;
+
+		MockConsole* m_pConsole;
+	};
+
+
+	// Create the host with the core services and boot the plugin with it
+	FCM::Result BootPlugin(FCM::AutoPtr<FCM::IFCMCallback>& pCallback);
+
+	// Stop what the plugin left running and let go of the host
+	FCM::Result ShutdownPlugin(FCM::AutoPtr<FCM::IFCMCallback>& pCallback);
+};
+
+#endif // HARNESS_MOCK_HOST_H_
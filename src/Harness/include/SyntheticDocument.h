@@ -0,0 +1,150 @@
+//
+//  SyntheticDocument.h
+//  PixiAnimate Harness
+//
+//  A generated document of symbols made of shapes, placed and moved on the
+//  stage, published through the plugin's palette, timeline builders and
+//  writers the way CPublisher::Export drives them for Animate.
+//
+
+#ifndef HARNESS_SYNTHETIC_DOCUMENT_H_
+#define HARNESS_SYNTHETIC_DOCUMENT_H_
+
+#include "MockDOM.h"
+
+#include "Exporter/Service/IResourcePalette.h"
+#include "Exporter/Service/ITimelineBuilderFactory.h"
+
+#include <string>
+#include <vector>
+
+namespace Harness
+{
+	// What to generate, the same seed gives the same document
+	struct SYNTHETIC_OPTIONS
+	{
+		FCM::U_Int32 seed;
+		FCM::U_Int32 symbolCount;
+		FCM::U_Int32 shapesPerSymbol;
+		FCM::U_Int32 fillsPerShape;
+		FCM::U_Int32 strokesPerShape;
+		FCM::U_Int32 edgesPerPath;
+		FCM::U_Int32 framesPerSymbol;
+		FCM::U_Int32 stageInstances;
+		FCM::U_Int32 stageFrames;
+
+		// Every nth shape repeats the one before it, every nth instance is
+		// named or tweened, 0 for none
+		FCM::U_Int32 copyInterval;
+		FCM::U_Int32 nameInterval;
+		FCM::U_Int32 tweenInterval;
+
+		SYNTHETIC_OPTIONS();
+	};
+
+
+	// The publish settings the writers take
+	struct PUBLISH_OPTIONS
+	{
+		// Ends with a slash, created when missing
+		std::string outputDir;
+		std::string outputFile;
+		bool compactShapes;
+		bool packShapes;
+		double shapeGrid;
+		bool instanceShapes;
+		bool tweenMoves;
+		int pathPrecision;
+
+		PUBLISH_OPTIONS();
+
+		// The data file EndDocument writes next to the output file
+		std::string GetDataFile() const;
+	};
+
+
+	// Seconds spent on each half of a publish
+	struct PUBLISH_TIMES
+	{
+		// Shapes, symbols, the stage and its tweens
+		double build;
+
+		// Writing the data file
+		double endDocument;
+	};
+
+
+	class SyntheticDocument
+	{
+	public:
+
+		SyntheticDocument(FCM::PIFCMCallback pCallback, const SYNTHETIC_OPTIONS& options);
+
+		FCM::Result Publish(const PUBLISH_OPTIONS& options, PUBLISH_TIMES& times);
+
+		FCM::U_Int32 GetShapeCount() const;
+
+	private:
+
+		struct SHAPE
+		{
+			FCM::U_Int32 resourceId;
+			FCM::AutoPtr<DOM::FrameElement::IShape> pShape;
+		};
+
+		struct SYMBOL
+		{
+			FCM::U_Int32 resourceId;
+			std::string name;
+			std::vector<SHAPE> shapes;
+		};
+
+		struct INSTANCE
+		{
+			FCM::U_Int32 symbol;
+			DOM::Utils::MATRIX2D matrix;
+			FCM::AutoPtr<DOM::FrameElement::IMovieClip> pMovieClip;
+		};
+
+		// Deterministic, so every run publishes the same document
+		FCM::U_Int32 Next();
+
+		double Random(double min, double max);
+
+		// Animate geometry is in twips
+		FCM::Float Twips(double value);
+
+		MockShape* CreateShape();
+
+		MockShape* CopyShape(const SHAPE& source, bool moved);
+
+		MockPath* CreatePath(double x, double y, double radius, bool closed);
+
+		FCM::PIFCMUnknown CreateFillStyle();
+
+		FCM::PIFCMDictionary CreateTween(const DOM::Utils::MATRIX2D& matrix);
+
+		void CreateStage();
+
+		FCM::Result PublishSymbol(Exporter::Service::ITimelineBuilderFactory* pFactory, SYMBOL& symbol);
+
+		FCM::Result PublishStage(Exporter::Service::ITimelineBuilderFactory* pFactory);
+
+		FCM::PIFCMCallback m_pCallback;
+
+		SYNTHETIC_OPTIONS m_options;
+
+		FCM::U_Int32 m_random;
+
+		std::vector<SYMBOL> m_symbols;
+
+		std::vector<INSTANCE> m_instances;
+
+		FCM::AutoPtr<DOM::ITimeline> m_pStage;
+
+		// The palette the shapes and symbols are added to
+		FCM::AutoPtr<Exporter::Service::IResourcePalette> m_pResourcePalette;
+	};
+};
+
+#endif // HARNESS_SYNTHETIC_DOCUMENT_H_
@@ -0,0 +1,6 @@
+//
+//  CoreFoundation.h
+//  PixiAnimate Harness
+//
+//  The plugin includes CoreFoundation on the Mac without using any of it.
+//
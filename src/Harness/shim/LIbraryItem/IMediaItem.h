@@ -0,0 +1,9 @@
+//
+//  IMediaItem.h
+//  PixiAnimate Harness
+//
+//  IOutputWriter.h includes this header with the folder name miscased,
+//  which only resolves on a case-insensitive file system.
+//
+
+#include "LibraryItem/IMediaItem.h"
@@ -0,0 +1,15 @@
+//
+//  Prefix.h
+//  PixiAnimate Harness
+//
+//  Included ahead of every plugin source on Linux, libc++ on the Mac
+//  pulls these in through the headers the plugin already includes.
+//
+
+#ifndef HARNESS_PREFIX_H_
+#define HARNESS_PREFIX_H_
+
+#include <memory>
+#include <unistd.h>
+
+#endif // HARNESS_PREFIX_H_
@@ -0,0 +1,21 @@
+//
+//  copyfile.h
+//  PixiAnimate Harness
+//
+//  The part of the Mac copyfile API the plugin uses, implemented with
+//  plain file copies in copyfile.cpp.
+//
+
+#ifndef HARNESS_COPYFILE_H_
+#define HARNESS_COPYFILE_H_
+
+typedef void* copyfile_state_t;
+
+#define COPYFILE_ALL 1
+#define COPYFILE_RECURSIVE 2
+#define COPYFILE_CLONE 4
+#define COPYFILE_DATA 8
+
+int copyfile(const char* from, const char* to, copyfile_state_t state, unsigned int flags);
+
+#endif // HARNESS_COPYFILE_H_
@@ -0,0 +1,119 @@
+//
+//  Benchmark.cpp
+//  PixiAnimate Harness
+//
+//  Publishes a synthetic document with a few combinations of the shape
+//  settings and reports how long the document took to build and to write.
+//
+//  PixiAnimateBenchmark [symbols] [iterations] [output folder]
+//
+
+#include "SyntheticDocument.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+using namespace Harness;
+
+struct MODE
+{
+	const char* name;
+	bool packShapes;
+	double shapeGrid;
+	bool instanceShapes;
+	bool tweenMoves;
+};
+
+static const MODE modes[] =
+{
+	{ "baseline", false, 0, false, false },
+	{ "grid", false, 0.05, false, false },
+	{ "packed", true, 0.05, false, false },
+	{ "instanced", true, 0.05, true, true },
+};
+
+int main(int argc, char* argv[])
+{
+	SYNTHETIC_OPTIONS options;
+	PUBLISH_OPTIONS publish;
+	int iterations = 5;
+
+	if (argc > 1)
+	{
+		options.symbolCount = (FCM::U_Int32)atoi(argv[1]);
+	}
+	if (argc > 2)
+	{
+		iterations = atoi(argv[2]);
+	}
+	publish.outputDir = argc > 3 ? std::string(argv[3]) + "/" : "bench_output/";
+	publish.outputFile = "bench.js";
+
+	FCM::AutoPtr<FCM::IFCMCallback> pCallback;
+	FCM::Result res = BootPlugin(pCallback);
+	if (FCM_FAILURE_CODE(res))
+	{
+		fprintf(stderr, "Failed to boot the plugin: %d\n", (int)res);
+		return 1;
+	}
+
+	MockHost* pHost = static_cast<MockHost*>(pCallback.m_Ptr);
+	pHost->GetConsole()->SetQuiet(true);
+	AddDOMServices(pHost);
+
+	int failed = 0;
+	{
+		SyntheticDocument document(pCallback, options);
+
+		printf("%u symbols, %u shapes, %u instances, %d iterations\n",
+			options.symbolCount, document.GetShapeCount(), options.stageInstances, iterations);
+		printf("%-10s %10s %10s %12s\n", "mode", "build ms", "write ms", "data bytes");
+
+		for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+		{
+			double build = 0;
+			double endDocument = 0;
+
+			publish.packShapes = modes[m].packShapes;
+			publish.shapeGrid = modes[m].shapeGrid;
+			publish.instanceShapes = modes[m].instanceShapes;
+			publish.tweenMoves = modes[m].tweenMoves;
+
+			for (int i = 0; i < iterations; i++)
+			{
+				PUBLISH_TIMES times;
+
+				remove(publish.GetDataFile().c_str());
+				pHost->GetConsole()->Clear();
+
+				res = document.Publish(publish, times);
+				if (FCM_FAILURE_CODE(res))
+				{
+					fprintf(stderr, "%s: publish failed: %d\n%s", modes[m].name, (int)res,
+						pHost->GetConsole()->GetLog().c_str());
+					failed++;
+					break;
+				}
+
+				build += times.build;
+				endDocument += times.endDocument;
+			}
+
+			struct stat info;
+			if (stat(publish.GetDataFile().c_str(), &info) != 0)
+			{
+				fprintf(stderr, "%s: no data file at %s\n", modes[m].name, publish.GetDataFile().c_str());
+				failed++;
+				continue;
+			}
+
+			printf("%-10s %10.2f %10.2f %12lld\n", modes[m].name,
+				build * 1000 / iterations, endDocument * 1000 / iterations, (long long)info.st_size);
+		}
+	}
+
+	ShutdownPlugin(pCallback);
+
+	return failed > 0 ? 1 : 0;
+}
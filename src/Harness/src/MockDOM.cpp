@@ -0,0 +1,706 @@
+//
+//  MockDOM.cpp
+//  PixiAnimate Harness
+//
+//  Lightweight stand-ins for the Animate document the plugin walks while
+//  publishing: shapes with their fills, strokes, paths and edges, symbol
+//  timelines with their layers and frames, and the services that read them.
+//
+
+#include "MockDOM.h"
+
+#include "ApplicationFCMPublicIDs.h"
+
+#include <string.h>
+
+namespace Harness
+{
+	static FCM::PIFCMList CreateList()
+	{
+		return static_cast<FCM::IFCMList*>(CreateMock<MockList>(NULL));
+	}
+
+	// Hand out a list with a reference for the caller
+	static FCM::Result CopyOut(FCM::PIFCMList pList, FCM::PIFCMList& pOut)
+	{
+		pOut = pList;
+		pOut->AddRef();
+		return FCM_SUCCESS;
+	}
+
+	static DOM::Utils::MATRIX2D Identity()
+	{
+		DOM::Utils::MATRIX2D matrix;
+		matrix.a = 1;
+		matrix.b = 0;
+		matrix.c = 0;
+		matrix.d = 1;
+		matrix.tx = 0;
+		matrix.ty = 0;
+		return matrix;
+	}
+
+	/* ----------------------------------------------------- MockEdge */
+
+	FCM::Result MockEdge::GetSegment(DOM::Utils::SEGMENT& segment)
+	{
+		segment = m_segment;
+		return FCM_SUCCESS;
+	}
+
+	void MockEdge::SetSegment(const DOM::Utils::SEGMENT& segment)
+	{
+		m_segment = segment;
+	}
+
+	/* ----------------------------------------------------- MockPath */
+
+	MockPath::MockPath()
+	{
+		m_pEdges = CreateList();
+		m_point.x = 0;
+		m_point.y = 0;
+	}
+
+	FCM::Result MockPath::GetEdges(FCM::PIFCMList& pEdgeList)
+	{
+		return CopyOut(m_pEdges, pEdgeList);
+	}
+
+	void MockPath::MoveTo(FCM::Float x, FCM::Float y)
+	{
+		m_point.x = x;
+		m_point.y = y;
+	}
+
+	void MockPath::LineTo(FCM::Float x, FCM::Float y)
+	{
+		DOM::Utils::SEGMENT segment;
+		segment.structSize = sizeof(DOM::Utils::SEGMENT);
+		segment.segmentType = DOM::Utils::LINE_SEGMENT;
+		segment.line.endPoint1 = m_point;
+		segment.line.endPoint2.x = x;
+		segment.line.endPoint2.y = y;
+		AddEdge(segment);
+	}
+
+	void MockPath::CurveTo(FCM::Float controlX, FCM::Float controlY, FCM::Float x, FCM::Float y)
+	{
+		DOM::Utils::SEGMENT segment;
+		segment.structSize = sizeof(DOM::Utils::SEGMENT);
+		segment.segmentType = DOM::Utils::QUAD_BEZIER_SEGMENT;
+		segment.quadBezierCurve.anchor1 = m_point;
+		segment.quadBezierCurve.control.x = controlX;
+		segment.quadBezierCurve.control.y = controlY;
+		segment.quadBezierCurve.anchor2.x = x;
+		segment.quadBezierCurve.anchor2.y = y;
+		AddEdge(segment);
+	}
+
+	void MockPath::AddEdge(const DOM::Utils::SEGMENT& segment)
+	{
+		MockEdge* pEdge = CreateMock<MockEdge>(GetCallback());
+		pEdge->SetSegment(segment);
+		static_cast<MockList*>(m_pEdges.m_Ptr)->Add(static_cast<IEdge*>(pEdge));
+
+		m_point = segment.segmentType == DOM::Utils::LINE_SEGMENT ?
+			segment.line.endPoint2 : segment.quadBezierCurve.anchor2;
+	}
+
+	/* ----------------------------------------------------- MockSolidFillStyle */
+
+	FCM::Result MockSolidFillStyle::GetColor(DOM::Utils::COLOR& color)
+	{
+		color = m_color;
+		return FCM_SUCCESS;
+	}
+
+	void MockSolidFillStyle::SetColor(const DOM::Utils::COLOR& color)
+	{
+		m_color = color;
+	}
+
+	/* ----------------------------------------------------- MockSolidStrokeStyle */
+
+	MockSolidStrokeStyle::MockSolidStrokeStyle() :
+		m_thickness(1)
+	{
+	}
+
+	FCM::Result MockSolidStrokeStyle::GetThickness(FCM::Double& thickness)
+	{
+		thickness = m_thickness;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockSolidStrokeStyle::GetFillStyle(FCM::PIFCMUnknown& pFillStyle)
+	{
+		pFillStyle = m_pFillStyle;
+		pFillStyle->AddRef();
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockSolidStrokeStyle::GetJoinStyle(DOM::StrokeStyle::JOIN_STYLE& joinStyle)
+	{
+		joinStyle.type = DOM::Utils::ROUND_JOIN;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockSolidStrokeStyle::GetCapStyle(DOM::StrokeStyle::CAP_STYLE& capStyle)
+	{
+		capStyle.type = DOM::Utils::ROUND_CAP;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockSolidStrokeStyle::GetScaleType(DOM::Utils::ScaleType& scaleType)
+	{
+		scaleType = DOM::Utils::STROKE_NORMAL_SCALE;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockSolidStrokeStyle::GetStrokeHinting(FCM::Boolean& strokeHinting)
+	{
+		strokeHinting = false;
+		return FCM_SUCCESS;
+	}
+
+	// No variable width, so the stroke isn't fancy
+	FCM::Result MockSolidStrokeStyle::GetStrokeWidth(DOM::StrokeStyle::PIStrokeWidth& pStrokeWidth)
+	{
+		pStrokeWidth = NULL;
+		return FCM_SUCCESS;
+	}
+
+	void MockSolidStrokeStyle::SetThickness(FCM::Double thickness)
+	{
+		m_thickness = thickness;
+	}
+
+	void MockSolidStrokeStyle::SetFillStyle(FCM::PIFCMUnknown pFillStyle)
+	{
+		m_pFillStyle = pFillStyle;
+	}
+
+	/* ----------------------------------------------------- MockFilledRegion */
+
+	MockFilledRegion::MockFilledRegion()
+	{
+		m_pHoles = CreateList();
+	}
+
+	FCM::Result MockFilledRegion::GetBoundary(PIPath& pPath)
+	{
+		pPath = m_pBoundary;
+		pPath->AddRef();
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockFilledRegion::GetHoles(FCM::PIFCMList& pHoleList)
+	{
+		return CopyOut(m_pHoles, pHoleList);
+	}
+
+	FCM::Result MockFilledRegion::GetFillStyle(FCM::PIFCMUnknown& pFillStyle)
+	{
+		pFillStyle = m_pFillStyle;
+		pFillStyle->AddRef();
+		return FCM_SUCCESS;
+	}
+
+	void MockFilledRegion::SetBoundary(PIPath pPath)
+	{
+		m_pBoundary = pPath;
+	}
+
+	void MockFilledRegion::AddHole(PIPath pPath)
+	{
+		static_cast<MockList*>(m_pHoles.m_Ptr)->Add(pPath);
+	}
+
+	void MockFilledRegion::SetFillStyle(FCM::PIFCMUnknown pFillStyle)
+	{
+		m_pFillStyle = pFillStyle;
+	}
+
+	/* ----------------------------------------------------- MockStrokeGroup */
+
+	MockStrokeGroup::MockStrokeGroup()
+	{
+		m_pPaths = CreateList();
+	}
+
+	FCM::Result MockStrokeGroup::GetStrokeStyle(FCM::PIFCMUnknown& pStrokeStyle)
+	{
+		pStrokeStyle = m_pStrokeStyle;
+		pStrokeStyle->AddRef();
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockStrokeGroup::GetPaths(FCM::PIFCMList& pPathList)
+	{
+		return CopyOut(m_pPaths, pPathList);
+	}
+
+	void MockStrokeGroup::SetStrokeStyle(FCM::PIFCMUnknown pStrokeStyle)
+	{
+		m_pStrokeStyle = pStrokeStyle;
+	}
+
+	void MockStrokeGroup::AddPath(PIPath pPath)
+	{
+		static_cast<MockList*>(m_pPaths.m_Ptr)->Add(pPath);
+	}
+
+	/* ----------------------------------------------------- MockDisplayElement */
+
+	MockDisplayElement::MockDisplayElement() :
+		m_depth(0),
+		m_matrix(Identity())
+	{
+		memset(&m_bounds, 0, sizeof(m_bounds));
+	}
+
+	FCM::Result MockDisplayElement::GetDepth(FCM::U_Int32& depth)
+	{
+		depth = m_depth;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockDisplayElement::GetObjectSpaceBounds(DOM::Utils::RECT& rect)
+	{
+		rect = m_bounds;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockDisplayElement::GetBounds(DOM::Utils::RECT& rect)
+	{
+		rect = m_bounds;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockDisplayElement::GetMatrix(DOM::Utils::MATRIX2D& matrix)
+	{
+		matrix = m_matrix;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockDisplayElement::GetPivot(DOM::Utils::POINT2D& pivot)
+	{
+		pivot.x = 0;
+		pivot.y = 0;
+		return FCM_SUCCESS;
+	}
+
+	void MockDisplayElement::SetDepth(FCM::U_Int32 depth)
+	{
+		m_depth = depth;
+	}
+
+	void MockDisplayElement::SetBounds(const DOM::Utils::RECT& bounds)
+	{
+		m_bounds = bounds;
+	}
+
+	void MockDisplayElement::SetMatrix(const DOM::Utils::MATRIX2D& matrix)
+	{
+		m_matrix = matrix;
+	}
+
+	void MockDisplayElement::AddTweenInfo(FCM::PIFCMDictionary pTweenInfo)
+	{
+		if (!m_pTweenInfo)
+		{
+			m_pTweenInfo = CreateList();
+		}
+		static_cast<MockList*>(m_pTweenInfo.m_Ptr)->Add(pTweenInfo);
+	}
+
+	FCM::PIFCMList MockDisplayElement::GetTweenInfo() const
+	{
+		return m_pTweenInfo;
+	}
+
+	/* ----------------------------------------------------- MockShape */
+
+	MockShape::MockShape() :
+		m_mapAtoB(Identity())
+	{
+		m_pFills = CreateList();
+		m_pStrokes = CreateList();
+	}
+
+	void MockShape::AddFill(PIFilledRegion pFill)
+	{
+		static_cast<MockList*>(m_pFills.m_Ptr)->Add(pFill);
+	}
+
+	void MockShape::AddStroke(PIStrokeGroup pStroke)
+	{
+		static_cast<MockList*>(m_pStrokes.m_Ptr)->Add(pStroke);
+	}
+
+	void MockShape::SetCopyOf(PIShape pSource, const DOM::Utils::MATRIX2D& mapAtoB)
+	{
+		m_pSource = pSource;
+		m_mapAtoB = mapAtoB;
+	}
+
+	FCM::PIFCMList MockShape::GetFills() const
+	{
+		return m_pFills;
+	}
+
+	FCM::PIFCMList MockShape::GetStrokes() const
+	{
+		return m_pStrokes;
+	}
+
+	PIShape MockShape::GetSource() const
+	{
+		return m_pSource;
+	}
+
+	const DOM::Utils::MATRIX2D& MockShape::GetMapAtoB() const
+	{
+		return m_mapAtoB;
+	}
+
+	/* ----------------------------------------------------- MockMovieClip */
+
+	FCM::Result MockMovieClip::GetBlendMode(FCM::BlendMode& blendMode)
+	{
+		blendMode = FCM::NORMAL_BLEND_MODE;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockMovieClip::IsVisible(FCM::Boolean& isVisible)
+	{
+		isVisible = true;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockMovieClip::GetName(FCM::StringRep16* ppName)
+	{
+		return ToString16(m_name.c_str(), *ppName);
+	}
+
+	void MockMovieClip::SetName(const std::string& name)
+	{
+		m_name = name;
+	}
+
+	/* ----------------------------------------------------- MockFrame */
+
+	MockFrame::MockFrame() :
+		m_startFrameIndex(0),
+		m_duration(1)
+	{
+		m_pElements = CreateList();
+	}
+
+	FCM::Result MockFrame::GetDuration(FCM::U_Int32& duration)
+	{
+		duration = m_duration;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockFrame::GetFrameElements(FCM::PIFCMList& pFrameElementsList)
+	{
+		return CopyOut(m_pElements, pFrameElementsList);
+	}
+
+	FCM::Result MockFrame::GetFrameElementsByType(
+		FCM::ConstFCMIID& iid,
+		FCM::PIFCMList& pFrameElementsList)
+	{
+		FCM::U_Int32 count;
+		MockList* pList = CreateMock<MockList>(NULL);
+
+		m_pElements->Count(count);
+		for (FCM::U_Int32 i = 0; i < count; i++)
+		{
+			FCM::PIFCMUnknown pElement = NULL;
+			if (FCM_SUCCESS_CODE((*m_pElements)[i]->QueryInterface(iid, (FCM::PPVoid)&pElement)))
+			{
+				pList->Add(pElement);
+				pElement->Release();
+			}
+		}
+
+		pFrameElementsList = static_cast<FCM::IFCMList*>(pList);
+		pFrameElementsList->AddRef();
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockFrame::GetStartFrameIndex(FCM::U_Int32& frameIndex)
+	{
+		frameIndex = m_startFrameIndex;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockFrame::GetLabel(FCM::StringRep16* ppLabel)
+	{
+		*ppLabel = NULL;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockFrame::GetLabelType(DOM::KeyFrameLabelType& labelType)
+	{
+		labelType = DOM::KEY_FRAME_LABEL_NONE;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockFrame::GetScript(FCM::StringRep16* ppScript)
+	{
+		*ppScript = NULL;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockFrame::GetTween(DOM::PITween& pTween)
+	{
+		pTween = NULL;
+		return FCM_SUCCESS;
+	}
+
+	void MockFrame::SetFrames(FCM::U_Int32 startFrameIndex, FCM::U_Int32 duration)
+	{
+		m_startFrameIndex = startFrameIndex;
+		m_duration = duration;
+	}
+
+	void MockFrame::AddElement(PIFrameDisplayElement pElement)
+	{
+		static_cast<MockList*>(m_pElements.m_Ptr)->Add(pElement);
+	}
+
+	/* ----------------------------------------------------- MockLayer */
+
+	MockLayer::MockLayer() :
+		m_duration(0)
+	{
+		m_pKeyFrames = CreateList();
+	}
+
+	FCM::Result MockLayer::GetName(FCM::StringRep16* ppName)
+	{
+		return ToString16(m_name.c_str(), *ppName);
+	}
+
+	FCM::Result MockLayer::IsVisible(FCM::Boolean& isVisible)
+	{
+		isVisible = true;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockLayer::GetParentLayer(PILayer& pParentLayer)
+	{
+		pParentLayer = NULL;
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockLayer::GetLayerType(FCM::PIFCMUnknown& pLayerType)
+	{
+		pLayerType = static_cast<ILayerNormal*>(this);
+		pLayerType->AddRef();
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockLayer::GetKeyFrames(FCM::PIFCMList& pKeyFrameList)
+	{
+		return CopyOut(m_pKeyFrames, pKeyFrameList);
+	}
+
+	FCM::Result MockLayer::GetFrameAtIndex(FCM::U_Int32 index, PIFrame& pFrame)
+	{
+		FCM::U_Int32 count;
+
+		m_pKeyFrames->Count(count);
+		for (FCM::U_Int32 i = 0; i < count; i++)
+		{
+			PIFrame pKeyFrame = static_cast<PIFrame>((*m_pKeyFrames)[i]);
+			FCM::U_Int32 start;
+			FCM::U_Int32 duration;
+
+			pKeyFrame->GetStartFrameIndex(start);
+			pKeyFrame->GetDuration(duration);
+			if (index >= start && index < start + duration)
+			{
+				pFrame = pKeyFrame;
+				pFrame->AddRef();
+				return FCM_SUCCESS;
+			}
+		}
+
+		pFrame = NULL;
+		return FCM_INVALID_PARAM;
+	}
+
+	FCM::Result MockLayer::GetTotalDuration(FCM::U_Int32& duration)
+	{
+		duration = m_duration;
+		return FCM_SUCCESS;
+	}
+
+	void MockLayer::SetName(const std::string& name)
+	{
+		m_name = name;
+	}
+
+	void MockLayer::AddKeyFrame(MockFrame* pFrame, FCM::U_Int32 duration)
+	{
+		pFrame->SetFrames(m_duration, duration);
+		static_cast<MockList*>(m_pKeyFrames.m_Ptr)->Add(static_cast<IFrame*>(pFrame));
+		m_duration += duration;
+	}
+
+	/* ----------------------------------------------------- MockTimeline */
+
+	MockTimeline::MockTimeline()
+	{
+		m_pLayers = CreateList();
+	}
+
+	FCM::Result MockTimeline::GetName(FCM::StringRep16* ppName)
+	{
+		return ToString16(m_name.c_str(), *ppName);
+	}
+
+	FCM::Result MockTimeline::GetLayers(FCM::PIFCMList& pLayerList)
+	{
+		return CopyOut(m_pLayers, pLayerList);
+	}
+
+	FCM::Result MockTimeline::GetMaxFrameCount(FCM::U_Int32& frameCount)
+	{
+		FCM::U_Int32 count;
+
+		frameCount = 0;
+		m_pLayers->Count(count);
+		for (FCM::U_Int32 i = 0; i < count; i++)
+		{
+			MockLayer* pLayer = static_cast<MockLayer*>(static_cast<PILayer>((*m_pLayers)[i]));
+			FCM::U_Int32 duration;
+
+			pLayer->GetTotalDuration(duration);
+			if (duration > frameCount)
+			{
+				frameCount = duration;
+			}
+		}
+		return FCM_SUCCESS;
+	}
+
+	void MockTimeline::SetName(const std::string& name)
+	{
+		m_name = name;
+	}
+
+	void MockTimeline::AddLayer(MockLayer* pLayer)
+	{
+		static_cast<MockList*>(m_pLayers.m_Ptr)->Add(static_cast<ILayer*>(pLayer));
+	}
+
+	/* ----------------------------------------------------- MockRegionGeneratorService */
+
+	FCM::Result MockRegionGeneratorService::GetFilledRegions(PIShape pShape, FCM::PIFCMList& pFilledRegionList)
+	{
+		return CopyOut(static_cast<MockShape*>(pShape)->GetFills(), pFilledRegionList);
+	}
+
+	FCM::Result MockRegionGeneratorService::GetStrokeGroups(PIShape pShape, FCM::PIFCMList& pStrokeGroupList)
+	{
+		return CopyOut(static_cast<MockShape*>(pShape)->GetStrokes(), pStrokeGroupList);
+	}
+
+	/* ----------------------------------------------------- MockShapeService */
+
+	FCM::Result MockShapeService::ConvertStrokeToFill(PIShape pSrcShape, PIShape& pDstShape)
+	{
+		FCM::PIFCMList pStrokes = static_cast<MockShape*>(pSrcShape)->GetStrokes();
+		MockShape* pShape = CreateMock<MockShape>(GetCallback());
+		FCM::U_Int32 strokeCount;
+
+		pStrokes->Count(strokeCount);
+		for (FCM::U_Int32 i = 0; i < strokeCount; i++)
+		{
+			PIStrokeGroup pStroke = static_cast<PIStrokeGroup>((*pStrokes)[i]);
+			FCM::AutoPtr<FCM::IFCMUnknown> pStrokeStyle;
+			FCM::AutoPtr<FCM::IFCMUnknown> pFillStyle;
+			FCM::FCMListPtr pPaths;
+			FCM::U_Int32 pathCount;
+
+			pStroke->GetStrokeStyle(pStrokeStyle.m_Ptr);
+			static_cast<ISolidStrokeStyle*>(pStrokeStyle.m_Ptr)->GetFillStyle(pFillStyle.m_Ptr);
+
+			pStroke->GetPaths(pPaths.m_Ptr);
+			pPaths->Count(pathCount);
+			for (FCM::U_Int32 j = 0; j < pathCount; j++)
+			{
+				MockFilledRegion* pFill = CreateMock<MockFilledRegion>(GetCallback());
+				pFill->SetBoundary(static_cast<PIPath>((*pPaths)[j]));
+				pFill->SetFillStyle(pFillStyle);
+				pShape->AddFill(static_cast<IFilledRegion*>(pFill));
+			}
+		}
+
+		pDstShape = static_cast<IShape*>(pShape);
+		pDstShape->AddRef();
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockShapeService::TestShapeSimilarity(
+		PIShape pShapeA,
+		PIShape pShapeB,
+		FCM::Boolean& similar,
+		DOM::Utils::MATRIX2D& mapAtoB)
+	{
+		MockShape* pShape = static_cast<MockShape*>(pShapeB);
+
+		similar = pShape->GetSource() == pShapeA;
+		mapAtoB = similar ? pShape->GetMapAtoB() : Identity();
+		return FCM_SUCCESS;
+	}
+
+	/* ----------------------------------------------------- MockTweenInfoService */
+
+	FCM::Result MockTweenInfoService::GetFrameTweenInfo(PIFrame pFrame, FCM::PIFCMList& pTweenInfoList)
+	{
+		pTweenInfoList = NULL;
+		return FCM_GENERAL_ERROR;
+	}
+
+	// Elements without a tween fail, as they do in Animate
+	FCM::Result MockTweenInfoService::GetElementTweenInfo(
+		FCM::PIFCMCallback pCallback,
+		PIFrameDisplayElement pElement,
+		FCM::PIFCMList& pTweenInfoList)
+	{
+		FCM::PIFCMList pList = static_cast<MockDisplayElement*>(pElement)->GetTweenInfo();
+		if (pList == NULL)
+		{
+			pTweenInfoList = NULL;
+			return FCM_INVALID_PARAM;
+		}
+		return CopyOut(pList, pTweenInfoList);
+	}
+
+	FCM::Result MockTweenInfoService::GetShapeTweenInfo(PIFrame pFrame, FCM::PIFCMDictionary& pTweenInfo)
+	{
+		pTweenInfo = NULL;
+		return FCM_GENERAL_ERROR;
+	}
+
+	/* ----------------------------------------------------- Services */
+
+	void AddDOMServices(MockHost* pHost)
+	{
+		FCM::PIFCMCallback pCallback = static_cast<FCM::IFCMCallback*>(pHost);
+
+		pHost->AddService(DOM::FLA_REGION_GENERATOR_SERVICE,
+			static_cast<IRegionGeneratorService*>(CreateMock<MockRegionGeneratorService>(pCallback)));
+		pHost->AddService(DOM::FLA_SHAPE_SERVICE,
+			static_cast<IShapeService*>(CreateMock<MockShapeService>(pCallback)));
+		pHost->AddService(DOM::Service::Tween::TWEENINFO_SERVICE,
+			static_cast<ITweenInfoService*>(CreateMock<MockTweenInfoService>(pCallback)));
+	}
+};
@@ -0,0 +1,508 @@
+//
+//  MockHost.cpp
+//  PixiAnimate Harness
+//
+//  Stands in for Animate when the plugin is loaded outside of it: the
+//  callback the plugin creates its classes and gets its services through,
+//  and the core services every publish uses.
+//
+
+#include "MockHost.h"
+
+#include "FlashFCMPublicIDs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace PixiJS
+{
+	// Exported by the plugin in Main.cpp
+	extern "C" FCM::Result PluginBoot(FCM::PIFCMCallback pCallback);
+
+	extern "C" FCM::Result PluginGetClassObject(
+		FCM::PIFCMUnknown pUnkOuter,
+		FCM::ConstRefFCMCLSID clsid,
+		FCM::ConstRefFCMIID iid,
+		FCM::PPVoid pAny);
+
+	extern "C" FCM::Result PluginShutdown();
+};
+
+namespace Harness
+{
+	class MockModule : public FCM::FCMPluginModule
+	{
+	};
+
+	FCM::FCMPluginModule& GetMockModule()
+	{
+		static MockModule module;
+		return module;
+	}
+
+	/* ----------------------------------------------------- MockCalloc */
+
+	FCM::PVoid MockCalloc::Alloc(FCM::U_Int32 cb)
+	{
+		return calloc(1, cb);
+	}
+
+	void MockCalloc::Free(FCM::PVoid pv)
+	{
+		free(pv);
+	}
+
+	/* ----------------------------------------------------- MockStringUtils */
+
+	// UTF-8 to UTF-16, with pairs for the code points above the BMP
+	FCM::Result ToString16(FCM::CStringRep8 pStrSrc, FCM::StringRep16& pStrDest)
+	{
+		const unsigned char* src = (const unsigned char*)pStrSrc;
+		std::vector<FCM::U_Int16> dest;
+
+		while (*src)
+		{
+			FCM::U_Int32 codePoint;
+			int extra;
+
+			if (*src < 0x80)
+			{
+				codePoint = *src;
+				extra = 0;
+			}
+			else if ((*src & 0xE0) == 0xC0)
+			{
+				codePoint = *src & 0x1F;
+				extra = 1;
+			}
+			else if ((*src & 0xF0) == 0xE0)
+			{
+				codePoint = *src & 0x0F;
+				extra = 2;
+			}
+			else
+			{
+				codePoint = *src & 0x07;
+				extra = 3;
+			}
+			src++;
+
+			for (; extra > 0 && (*src & 0xC0) == 0x80; extra--)
+			{
+				codePoint = (codePoint << 6) | (*src++ & 0x3F);
+			}
+
+			if (codePoint >= 0x10000)
+			{
+				codePoint -= 0x10000;
+				dest.push_back((FCM::U_Int16)(0xD800 + (codePoint >> 10)));
+				dest.push_back((FCM::U_Int16)(0xDC00 + (codePoint & 0x3FF)));
+			}
+			else
+			{
+				dest.push_back((FCM::U_Int16)codePoint);
+			}
+		}
+		dest.push_back(0);
+
+		pStrDest = (FCM::StringRep16)calloc(dest.size(), sizeof(FCM::U_Int16));
+		if (pStrDest == NULL)
+		{
+			return FCM_MEM_NOT_AVAILABLE;
+		}
+		memcpy(pStrDest, &dest[0], dest.size() * sizeof(FCM::U_Int16));
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result ToString8(FCM::CStringRep16 pStrSrc, FCM::StringRep8& pStrDest)
+	{
+		std::string dest;
+
+		for (; *pStrSrc; pStrSrc++)
+		{
+			FCM::U_Int32 codePoint = *pStrSrc;
+
+			if (codePoint >= 0xD800 && codePoint < 0xDC00 && pStrSrc[1] >= 0xDC00 && pStrSrc[1] < 0xE000)
+			{
+				codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (pStrSrc[1] - 0xDC00);
+				pStrSrc++;
+			}
+
+			if (codePoint < 0x80)
+			{
+				dest += (char)codePoint;
+			}
+			else if (codePoint < 0x800)
+			{
+				dest += (char)(0xC0 | (codePoint >> 6));
+				dest += (char)(0x80 | (codePoint & 0x3F));
+			}
+			else if (codePoint < 0x10000)
+			{
+				dest += (char)(0xE0 | (codePoint >> 12));
+				dest += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+				dest += (char)(0x80 | (codePoint & 0x3F));
+			}
+			else
+			{
+				dest += (char)(0xF0 | (codePoint >> 18));
+				dest += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+				dest += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+				dest += (char)(0x80 | (codePoint & 0x3F));
+			}
+		}
+
+		pStrDest = (FCM::StringRep8)calloc(dest.size() + 1, 1);
+		if (pStrDest == NULL)
+		{
+			return FCM_MEM_NOT_AVAILABLE;
+		}
+		memcpy(pStrDest, dest.c_str(), dest.size());
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockStringUtils::ConvertStringRep8to16(FCM::CStringRep8 pStrSrc, FCM::StringRep16& pStrDest)
+	{
+		return ToString16(pStrSrc, pStrDest);
+	}
+
+	FCM::Result MockStringUtils::ConvertStringRep16to8(FCM::CStringRep16 pStrSrc, FCM::StringRep8& pStrDest)
+	{
+		return ToString8(pStrSrc, pStrDest);
+	}
+
+	/* ----------------------------------------------------- MockConsole */
+
+	MockConsole::MockConsole() :
+		m_quiet(false)
+	{
+	}
+
+	FCM::Result MockConsole::Trace(FCM::CStringRep16 pMessage)
+	{
+		FCM::StringRep8 message;
+
+		FCM::Result res = ToString8(pMessage, message);
+		if (FCM_FAILURE_CODE(res))
+		{
+			return res;
+		}
+
+		m_log += message;
+		if (!m_quiet)
+		{
+			fputs(message, stderr);
+		}
+
+		free(message);
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockConsole::Clear()
+	{
+		m_log.clear();
+		return FCM_SUCCESS;
+	}
+
+	void MockConsole::SetQuiet(bool quiet)
+	{
+		m_quiet = quiet;
+	}
+
+	const std::string& MockConsole::GetLog() const
+	{
+		return m_log;
+	}
+
+	/* ----------------------------------------------------- MockList */
+
+	MockList::MockList()
+	{
+	}
+
+	MockList::~MockList()
+	{
+		for (size_t i = 0; i < m_items.size(); i++)
+		{
+			m_items[i]->Release();
+		}
+	}
+
+	FCM::Result MockList::Count(FCM::U_Int32& count)
+	{
+		count = (FCM::U_Int32)m_items.size();
+		return FCM_SUCCESS;
+	}
+
+	FCM::PIFCMUnknown MockList::operator [](FCM::U_Int32 index)
+	{
+		return index < m_items.size() ? m_items[index] : NULL;
+	}
+
+	void MockList::Add(FCM::PIFCMUnknown pItem)
+	{
+		pItem->AddRef();
+		m_items.push_back(pItem);
+	}
+
+	/* ----------------------------------------------------- MockDictionary */
+
+	FCM::Result MockDictionary::Add(
+		FCM::CStringRep8 pKey,
+		FCM::FCMDictRecTypeID type,
+		FCM::PVoid value,
+		FCM::U_Int32 valueLen)
+	{
+		if (type == FCM::kFCMDictType_Dict)
+		{
+			return FCM_DICT_ERR_INVALID_KEY_TYPE;
+		}
+
+		if (Find(pKey) != NULL)
+		{
+			return FCM_DICT_ERR_EXISING_KEY_FOUND;
+		}
+
+		ENTRY entry;
+		entry.key = pKey;
+		entry.type = type;
+		entry.value.assign((FCM::Byte*)value, (FCM::Byte*)value + valueLen);
+		m_entries.push_back(entry);
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockDictionary::AddLevel(FCM::CStringRep8 pKey, FCM::PIFCMDictionary& ppDict)
+	{
+		if (Find(pKey) != NULL)
+		{
+			return FCM_DICT_ERR_EXISING_KEY_FOUND;
+		}
+
+		ENTRY entry;
+		entry.key = pKey;
+		entry.type = FCM::kFCMDictType_Dict;
+		entry.pLevel = static_cast<FCM::IFCMDictionary*>(CreateMock<MockDictionary>(GetCallback()));
+		m_entries.push_back(entry);
+
+		ppDict = entry.pLevel;
+		ppDict->AddRef();
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockDictionary::Remove(FCM::CStringRep8 pKey)
+	{
+		for (size_t i = 0; i < m_entries.size(); i++)
+		{
+			if (m_entries[i].key == pKey)
+			{
+				m_entries.erase(m_entries.begin() + i);
+				return FCM_SUCCESS;
+			}
+		}
+		return FCM_DICT_ERR_KEY_NOT_FOUND;
+	}
+
+	FCM::Result MockDictionary::Get(
+		FCM::CStringRep8 pKey,
+		FCM::FCMDictRecTypeID type,
+		FCM::PVoid pValue,
+		FCM::U_Int32& valueLen)
+	{
+		ENTRY* entry = Find(pKey);
+		if (entry == NULL)
+		{
+			return FCM_DICT_ERR_KEY_NOT_FOUND;
+		}
+
+		if (entry->type != type)
+		{
+			return FCM_DICT_ERR_WRONGTYPE;
+		}
+
+		if (type == FCM::kFCMDictType_Dict)
+		{
+			*(FCM::PIFCMDictionary*)pValue = entry->pLevel;
+			return FCM_SUCCESS;
+		}
+
+		if (valueLen < entry->value.size())
+		{
+			return FCM_DICT_ERR_BUFFERTOOSMALL;
+		}
+
+		if (!entry->value.empty())
+		{
+			memcpy(pValue, &entry->value[0], entry->value.size());
+		}
+		valueLen = (FCM::U_Int32)entry->value.size();
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockDictionary::Clear()
+	{
+		m_entries.clear();
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockDictionary::Count(FCM::U_Int32& count)
+	{
+		count = (FCM::U_Int32)m_entries.size();
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockDictionary::GetNth(
+		FCM::U_Int32 index,
+		FCM::StringRep8& pKey,
+		FCM::FCMDictRecTypeID& type,
+		FCM::U_Int32& valueLen)
+	{
+		if (index >= m_entries.size())
+		{
+			return FCM_DICT_ERR_NOTFOUND;
+		}
+
+		ENTRY& entry = m_entries[index];
+		pKey = (FCM::StringRep8)entry.key.c_str();
+		type = entry.type;
+		valueLen = (FCM::U_Int32)entry.value.size();
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result MockDictionary::GetInfo(
+		FCM::CStringRep8 pKey,
+		FCM::FCMDictRecTypeID& type,
+		FCM::U_Int32& valueLen)
+	{
+		ENTRY* entry = Find(pKey);
+		if (entry == NULL)
+		{
+			return FCM_DICT_ERR_KEY_NOT_FOUND;
+		}
+
+		type = entry->type;
+		valueLen = entry->type == FCM::kFCMDictType_Dict ?
+			(FCM::U_Int32)sizeof(FCM::PIFCMDictionary) : (FCM::U_Int32)entry->value.size();
+		return FCM_SUCCESS;
+	}
+
+	void MockDictionary::AddString(const std::string& key, const std::string& value)
+	{
+		Add(key.c_str(), FCM::kFCMDictType_StringRep8, (FCM::PVoid)value.c_str(), (FCM::U_Int32)value.size() + 1);
+	}
+
+	void MockDictionary::AddDouble(const std::string& key, FCM::Double value)
+	{
+		Add(key.c_str(), FCM::kFCMDictType_Double, &value, sizeof(value));
+	}
+
+	MockDictionary* MockDictionary::AddLevel(const std::string& key)
+	{
+		FCM::AutoPtr<FCM::IFCMDictionary> pLevel;
+		if (FCM_FAILURE_CODE(AddLevel(key.c_str(), pLevel.m_Ptr)))
+		{
+			return NULL;
+		}
+		return static_cast<MockDictionary*>(pLevel.m_Ptr);
+	}
+
+	MockDictionary::ENTRY* MockDictionary::Find(FCM::CStringRep8 pKey)
+	{
+		for (size_t i = 0; i < m_entries.size(); i++)
+		{
+			if (m_entries[i].key == pKey)
+			{
+				return &m_entries[i];
+			}
+		}
+		return NULL;
+	}
+
+	/* ----------------------------------------------------- MockHost */
+
+	MockHost::MockHost() :
+		m_pConsole(NULL)
+	{
+	}
+
+	FCM::Result MockHost::CreateInstance(
+		FCM::PIFCMUnknown pUnkOuter,
+		FCM::ConstRefFCMCLSID clsid,
+		FCM::ConstRefFCMIID interfaceID,
+		FCM::PPVoid ppvObj)
+	{
+		FCM::AutoPtr<FCM::IFCMClassFactory> pFactory;
+
+		FCM::Result res = PixiJS::PluginGetClassObject(
+			NULL,
+			clsid,
+			FCM::IID_IFCMClassFactory,
+			(FCM::PPVoid)&pFactory.m_Ptr);
+		if (FCM_FAILURE_CODE(res))
+		{
+			return res;
+		}
+
+		return pFactory->CreateInstance(pUnkOuter, this, interfaceID, ppvObj);
+	}
+
+	FCM::Result MockHost::GetService(
+		const FCM::SRVCID& serviceId,
+		FCM::PIFCMUnknown& pUnknown)
+	{
+		for (size_t i = 0; i < m_services.size(); i++)
+		{
+			if (m_services[i].first == serviceId)
+			{
+				pUnknown = m_services[i].second;
+				pUnknown->AddRef();
+				return FCM_SUCCESS;
+			}
+		}
+
+		pUnknown = NULL;
+		return FCM_SERVICE_NOT_FOUND;
+	}
+
+	void MockHost::AddService(const FCM::SRVCID& serviceId, FCM::PIFCMUnknown pService)
+	{
+		m_services.push_back(std::make_pair(serviceId, FCM::AutoPtr<FCM::IFCMUnknown>(pService)));
+	}
+
+	MockConsole* MockHost::GetConsole() const
+	{
+		return m_pConsole;
+	}
+
+	void MockHost::SetConsole(MockConsole* pConsole)
+	{
+		m_pConsole = pConsole;
+	}
+
+	/* ----------------------------------------------------- Plugin */
+
+	FCM::Result BootPlugin(FCM::AutoPtr<FCM::IFCMCallback>& pCallback)
+	{
+		MockHost* pHost = CreateMock<MockHost>(NULL);
+		pCallback = static_cast<FCM::IFCMCallback*>(pHost);
+
+		MockConsole* pConsole = CreateMock<MockConsole>(pCallback);
+		pHost->SetConsole(pConsole);
+
+		pHost->AddService(FCM::SRVCID_Core_Memory, static_cast<FCM::IFCMCalloc*>(CreateMock<MockCalloc>(pCallback)));
+		pHost->AddService(FCM::SRVCID_Core_StringUtils, static_cast<FCM::IFCMStringUtils*>(CreateMock<MockStringUtils>(pCallback)));
+		pHost->AddService(Application::Service::FLASHAPP_OUTPUT_CONSOLE_SERVICE,
+			static_cast<Application::Service::IOutputConsoleService*>(pConsole));
+
+		return PixiJS::PluginBoot(pCallback);
+	}
+
+	FCM::Result ShutdownPlugin(FCM::AutoPtr<FCM::IFCMCallback>& pCallback)
+	{
+		FCM::Result res = PixiJS::PluginShutdown();
+
+		pCallback.Reset();
+
+		return res;
+	}
+};
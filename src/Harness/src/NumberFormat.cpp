@@ -0,0 +1,161 @@
+//
+//  NumberFormat.cpp
+//  PixiAnimate Harness
+//
+//  Checks that libjson's _ftoa, with the PixiAnimate _fixedtoa fast path,
+//  prints the same digits as the stock printf path, and times the two.
+//  The numbers are the kinds the writers produce, plus values on and next
+//  to the halfway point between two outputs, which are checked but not timed.
+//
+//  PixiAnimateNumberFormat [count]
+//
+
+#include "JSONNode.h"
+#include "NumberToString.h"
+
+#include <chrono>
+#include <cmath>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+// _ftoa as libjson 7.6.1 ships it
+static json_string StockFormat(json_number value)
+{
+	if (value >= 0.0 && _floatsAreEqual(value, (json_number)((unsigned EXTRA_LONG long)value)))
+	{
+		return NumberToString::_uitoa<unsigned EXTRA_LONG long>((unsigned EXTRA_LONG long)value);
+	}
+	if (_floatsAreEqual(value, (json_number)((long EXTRA_LONG)value)))
+	{
+		return NumberToString::_itoa<long EXTRA_LONG>((long EXTRA_LONG)value);
+	}
+
+	json_char num_str_result[64];
+	snprintf(num_str_result, 63, FLOAT_STRING, (EXTRA_LONG double)value);
+
+	for (json_char* pos = &num_str_result[0]; *pos; ++pos)
+	{
+		if (*pos == '.')
+		{
+			for (json_char* runner = pos + 1; *runner; ++runner)
+			{
+				if (*runner != JSON_TEXT('0'))
+				{
+					pos = runner + 1;
+				}
+			}
+			*pos = JSON_TEXT('\0');
+			break;
+		}
+	}
+	return json_string(num_str_result);
+}
+
+static unsigned int state = 1;
+
+static double Random()
+{
+	state = state * 1664525u + 1013904223u;
+	return (state >> 8) / 16777216.0;
+}
+
+// Numbers like the ones the writers produce
+static std::vector<json_number> CreateValues(size_t count)
+{
+	std::vector<json_number> values;
+	values.reserve(count);
+
+	while (values.size() < count)
+	{
+		switch (values.size() % 4)
+		{
+		case 0:
+			// Path points
+			values.push_back(Random() * 4000 - 2000);
+			break;
+		case 1:
+			// Matrices, widened from FCM::Float
+			values.push_back((float)(Random() * 4 - 2));
+			break;
+		case 2:
+			// Alpha
+			values.push_back((int)(Random() * 256) / 255.0);
+			break;
+		default:
+			// Color offsets and other small numbers
+			values.push_back(Random() * 2e-3 - 1e-3);
+			break;
+		}
+	}
+	return values;
+}
+
+// Numbers on and just either side of halfway between two outputs
+static std::vector<json_number> CreateTies(size_t count)
+{
+	std::vector<json_number> values;
+	values.reserve(count);
+
+	while (values.size() < count)
+	{
+		double tie = (floor(Random() * 2e9) + 0.5) / 1e6 - 1000;
+		values.push_back(tie);
+		values.push_back(nextafter(tie, 1e10));
+		values.push_back(nextafter(tie, -1e10));
+
+		// Exactly halfway, printf rounds these to even
+		values.push_back(floor(Random() * 2000) + (2 * floor(Random() * 64) + 1) / 128.0);
+	}
+	return values;
+}
+
+static int Compare(const std::vector<json_number>& values)
+{
+	int mismatches = 0;
+
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		json_string fast = NumberToString::_ftoa(values[i]);
+		json_string stock = StockFormat(values[i]);
+		if (fast != stock)
+		{
+			if (mismatches < 10)
+			{
+				fprintf(stderr, "%.17g printed as %s, printf gives %s\n",
+					(double)values[i], fast.c_str(), stock.c_str());
+			}
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = argc > 1 ? (size_t)atol(argv[1]) : 3000000;
+	std::vector<json_number> values = CreateValues(count);
+	std::vector<json_number> ties = CreateTies(count / 10);
+	size_t length = 0;
+	int mismatches = Compare(values) + Compare(ties);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		length += NumberToString::_ftoa(values[i]).length();
+	}
+	std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		length += StockFormat(values[i]).length();
+	}
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+	printf("%u values and %u ties, %d different, %u characters\n",
+		(unsigned int)values.size(), (unsigned int)ties.size(), mismatches, (unsigned int)length / 2);
+	printf("_ftoa %10.2f ms\n", std::chrono::duration<double, std::milli>(middle - start).count());
+	printf("printf %9.2f ms\n", std::chrono::duration<double, std::milli>(end - middle).count());
+
+	return mismatches > 0 ? 1 : 0;
+}
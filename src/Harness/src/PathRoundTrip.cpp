@@ -0,0 +1,99 @@
+//
+//  PathRoundTrip.cpp
+//  PixiAnimate Harness
+//
+//  Publishes one synthetic document three times into the output folder, as
+//  absolute points (absolute.json), quantised JSON deltas (grid.json) and
+//  quantised packed varints (packed.json), for test/PathRoundTrip.js to
+//  decode and compare.
+//
+//  PixiAnimatePathRoundTrip [output folder] [grid]
+//
+
+#include "SyntheticDocument.h"
+
+#include "Utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Harness;
+
+struct MODE
+{
+	const char* outputFile;
+	bool packShapes;
+	bool quantised;
+};
+
+static const MODE modes[] =
+{
+	{ "absolute.js", false, false },
+	{ "grid.js", false, true },
+	{ "packed.js", true, true },
+};
+
+int main(int argc, char* argv[])
+{
+	SYNTHETIC_OPTIONS options;
+	PUBLISH_OPTIONS publish;
+
+	// Off the twip grid the geometry is made on, so points are really rounded
+	double shapeGrid = 0.3;
+
+	// Enough for every path to start far from the origin and from the
+	// previous fill or stroke
+	options.symbolCount = 4;
+	options.stageInstances = 4;
+	options.stageFrames = 4;
+
+	publish.outputDir = argc > 1 ? std::string(argv[1]) + "/" : "roundtrip_output/";
+	if (argc > 2)
+	{
+		shapeGrid = atof(argv[2]);
+	}
+
+	FCM::AutoPtr<FCM::IFCMCallback> pCallback;
+	FCM::Result res = BootPlugin(pCallback);
+	if (FCM_FAILURE_CODE(res))
+	{
+		fprintf(stderr, "Failed to boot the plugin: %d\n", (int)res);
+		return 1;
+	}
+
+	MockHost* pHost = static_cast<MockHost*>(pCallback.m_Ptr);
+	pHost->GetConsole()->SetQuiet(true);
+	AddDOMServices(pHost);
+
+	int failed = 0;
+	{
+		SyntheticDocument document(pCallback, options);
+
+		for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+		{
+			PUBLISH_TIMES times;
+
+			publish.outputFile = modes[m].outputFile;
+			publish.packShapes = modes[m].packShapes;
+			publish.shapeGrid = modes[m].quantised ? shapeGrid : 0;
+			publish.pathPrecision = MAX_PRECISION;
+
+			remove(publish.GetDataFile().c_str());
+			pHost->GetConsole()->Clear();
+
+			res = document.Publish(publish, times);
+			if (FCM_FAILURE_CODE(res))
+			{
+				fprintf(stderr, "%s: publish failed: %d\n%s", modes[m].outputFile, (int)res,
+					pHost->GetConsole()->GetLog().c_str());
+				failed++;
+				continue;
+			}
+			printf("%s\n", publish.GetDataFile().c_str());
+		}
+	}
+
+	ShutdownPlugin(pCallback);
+
+	return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,569 @@
+//
+//  SyntheticDocument.cpp
+//  PixiAnimate Harness
+//
+//  A generated document of symbols made of shapes, placed and moved on the
+//  stage, published through the plugin's palette, timeline builders and
+//  writers the way CPublisher::Export drives them for Animate.
+//
+
+#include "SyntheticDocument.h"
+
+#include "ApplicationFCMPublicIDs.h"
+#include "Publisher.h"
+#include "OutputWriter.h"
+#include "TweenWriter.h"
+#include "Utils.h"
+
+#include <chrono>
+#include <math.h>
+#include <memory>
+#include <stdlib.h>
+
+namespace Harness
+{
+	static double Seconds(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	static DOM::Utils::MATRIX2D Translate(double x, double y)
+	{
+		DOM::Utils::MATRIX2D matrix;
+		matrix.a = 1;
+		matrix.b = 0;
+		matrix.c = 0;
+		matrix.d = 1;
+		matrix.tx = (FCM::Float)x;
+		matrix.ty = (FCM::Float)y;
+		return matrix;
+	}
+
+	/* ----------------------------------------------------- Options */
+
+	SYNTHETIC_OPTIONS::SYNTHETIC_OPTIONS() :
+		seed(1),
+		symbolCount(20),
+		shapesPerSymbol(8),
+		fillsPerShape(3),
+		strokesPerShape(1),
+		edgesPerPath(24),
+		framesPerSymbol(12),
+		stageInstances(40),
+		stageFrames(60),
+		copyInterval(4),
+		nameInterval(3),
+		tweenInterval(5)
+	{
+	}
+
+	PUBLISH_OPTIONS::PUBLISH_OPTIONS() :
+		outputDir("./"),
+		outputFile("synthetic.js"),
+		compactShapes(true),
+		packShapes(false),
+		shapeGrid(0),
+		instanceShapes(false),
+		tweenMoves(false),
+		pathPrecision(2)
+	{
+	}
+
+	std::string PUBLISH_OPTIONS::GetDataFile() const
+	{
+		return outputDir + outputFile + "on";
+	}
+
+	/* ----------------------------------------------------- SyntheticDocument */
+
+	SyntheticDocument::SyntheticDocument(FCM::PIFCMCallback pCallback, const SYNTHETIC_OPTIONS& options) :
+		m_pCallback(pCallback),
+		m_options(options),
+		m_random(options.seed)
+	{
+		FCM::U_Int32 resourceId = 1;
+
+		for (FCM::U_Int32 i = 0; i < m_options.symbolCount; i++)
+		{
+			SYMBOL symbol;
+			symbol.name = "Symbol" + PixiJS::Utils::ToString(i);
+
+			for (FCM::U_Int32 j = 0; j < m_options.shapesPerSymbol; j++)
+			{
+				SHAPE shape;
+				shape.resourceId = resourceId++;
+
+				if (j > 0 && m_options.copyInterval > 0 && j % m_options.copyInterval == 0)
+				{
+					// Every other repeat is moved, the rest are duplicates
+					shape.pShape = static_cast<IShape*>(CopyShape(symbol.shapes.back(), (j / m_options.copyInterval) % 2 == 0));
+				}
+				else
+				{
+					shape.pShape = static_cast<IShape*>(CreateShape());
+				}
+				symbol.shapes.push_back(shape);
+			}
+
+			symbol.resourceId = resourceId++;
+			m_symbols.push_back(symbol);
+		}
+
+		CreateStage();
+	}
+
+	FCM::U_Int32 SyntheticDocument::GetShapeCount() const
+	{
+		return m_options.symbolCount * m_options.shapesPerSymbol;
+	}
+
+	FCM::U_Int32 SyntheticDocument::Next()
+	{
+		m_random = m_random * 1664525 + 1013904223;
+		return m_random;
+	}
+
+	double SyntheticDocument::Random(double min, double max)
+	{
+		return min + (max - min) * (Next() >> 8) / (double)(1 << 24);
+	}
+
+	FCM::Float SyntheticDocument::Twips(double value)
+	{
+		return (FCM::Float)(floor(value * 20 + 0.5) / 20);
+	}
+
+	// Fills and strokes spread far apart, so each one starts well away from
+	// where the last one ended
+	MockShape* SyntheticDocument::CreateShape()
+	{
+		MockShape* pShape = CreateMock<MockShape>(m_pCallback);
+		DOM::Utils::RECT bounds;
+		double radius = 0;
+
+		double x = Random(-2000, 2000);
+		double y = Random(-2000, 2000);
+
+		for (FCM::U_Int32 i = 0; i < m_options.fillsPerShape; i++)
+		{
+			MockFilledRegion* pFill = CreateMock<MockFilledRegion>(m_pCallback);
+			double fillRadius = Random(10, 200);
+
+			pFill->SetBoundary(CreatePath(x + i * 400, y, fillRadius, true));
+			pFill->SetFillStyle(CreateFillStyle());
+			if (i % 2 == 1)
+			{
+				pFill->AddHole(CreatePath(x + i * 400, y, fillRadius / 2, true));
+			}
+			pShape->AddFill(static_cast<IFilledRegion*>(pFill));
+
+			radius = fmax(radius, fillRadius + i * 400);
+		}
+
+		for (FCM::U_Int32 i = 0; i < m_options.strokesPerShape; i++)
+		{
+			MockStrokeGroup* pStroke = CreateMock<MockStrokeGroup>(m_pCallback);
+			MockSolidStrokeStyle* pStrokeStyle = CreateMock<MockSolidStrokeStyle>(m_pCallback);
+			double strokeRadius = Random(10, 200);
+
+			pStrokeStyle->SetThickness(Twips(Random(0.5, 5)));
+			pStrokeStyle->SetFillStyle(CreateFillStyle());
+			pStroke->SetStrokeStyle(static_cast<ISolidStrokeStyle*>(pStrokeStyle));
+			pStroke->AddPath(CreatePath(x, y - (i + 1) * 400, strokeRadius, false));
+			pShape->AddStroke(static_cast<IStrokeGroup*>(pStroke));
+
+			radius = fmax(radius, strokeRadius + (i + 1) * 400);
+		}
+
+		bounds.topLeft.x = Twips(x - radius);
+		bounds.topLeft.y = Twips(y - radius);
+		bounds.bottomRight.x = Twips(x + radius);
+		bounds.bottomRight.y = Twips(y + radius);
+		pShape->SetBounds(bounds);
+
+		return pShape;
+	}
+
+	// The same fills and strokes, placed where the shape service reports
+	MockShape* SyntheticDocument::CopyShape(const SHAPE& source, bool moved)
+	{
+		MockShape* pSource = static_cast<MockShape*>(source.pShape.m_Ptr);
+		MockShape* pShape = CreateMock<MockShape>(m_pCallback);
+		DOM::Utils::RECT bounds;
+		FCM::U_Int32 count;
+
+		pSource->GetFills()->Count(count);
+		for (FCM::U_Int32 i = 0; i < count; i++)
+		{
+			pShape->AddFill(static_cast<PIFilledRegion>((*pSource->GetFills())[i]));
+		}
+
+		pSource->GetStrokes()->Count(count);
+		for (FCM::U_Int32 i = 0; i < count; i++)
+		{
+			pShape->AddStroke(static_cast<PIStrokeGroup>((*pSource->GetStrokes())[i]));
+		}
+
+		pSource->GetObjectSpaceBounds(bounds);
+		pShape->SetBounds(bounds);
+		pShape->SetCopyOf(source.pShape, moved ? Translate(Twips(Random(-50, 50)), Twips(Random(-50, 50))) : Translate(0, 0));
+
+		return pShape;
+	}
+
+	// A ring of lines and curves around a point
+	MockPath* SyntheticDocument::CreatePath(double x, double y, double radius, bool closed)
+	{
+		MockPath* pPath = CreateMock<MockPath>(m_pCallback);
+		FCM::U_Int32 edgeCount = m_options.edgesPerPath > 0 ? m_options.edgesPerPath : 1;
+		double step = 2 * M_PI / edgeCount;
+
+		pPath->MoveTo(Twips(x + radius), Twips(y));
+
+		for (FCM::U_Int32 i = 1; i <= edgeCount; i++)
+		{
+			double angle = closed ? i * step : i * step * 0.75;
+			double r = radius * Random(0.8, 1.2);
+			double endX = x + (closed && i == edgeCount ? radius : r * cos(angle));
+			double endY = y + (closed && i == edgeCount ? 0 : r * sin(angle));
+
+			if (i % 2 == 0)
+			{
+				double control = angle - step / 2;
+				pPath->CurveTo(
+					Twips(x + r * 1.1 * cos(control)),
+					Twips(y + r * 1.1 * sin(control)),
+					Twips(endX),
+					Twips(endY));
+			}
+			else
+			{
+				pPath->LineTo(Twips(endX), Twips(endY));
+			}
+		}
+
+		return pPath;
+	}
+
+	FCM::PIFCMUnknown SyntheticDocument::CreateFillStyle()
+	{
+		MockSolidFillStyle* pFillStyle = CreateMock<MockSolidFillStyle>(m_pCallback);
+		DOM::Utils::COLOR color;
+
+		color.red = (FCM::Byte)(Next() >> 24);
+		color.green = (FCM::Byte)(Next() >> 24);
+		color.blue = (FCM::Byte)(Next() >> 24);
+		color.alpha = Next() % 4 == 0 ? 128 : 255;
+		pFillStyle->SetColor(color);
+
+		return static_cast<ISolidFillStyle*>(pFillStyle);
+	}
+
+	// A geometric tween from where an instance is placed, as Animate
+	// reports them
+	FCM::PIFCMDictionary SyntheticDocument::CreateTween(const DOM::Utils::MATRIX2D& matrix)
+	{
+		MockDictionary* pTween = CreateMock<MockDictionary>(m_pCallback);
+		pTween->AddString(kTweenKey_TweenType, "geometric");
+
+		MockDictionary* pMotion = pTween->AddLevel("Motion_XY");
+		MockDictionary* pStates = pMotion->AddLevel("Property_States");
+		MockDictionary* pStart = pStates->AddLevel("Start_Value");
+		pStart->AddDouble("Pos_X", matrix.tx);
+		pStart->AddDouble("Pos_Y", matrix.ty);
+		MockDictionary* pEnd = pStates->AddLevel("End_Value");
+		pEnd->AddDouble("Pos_X", matrix.tx + Twips(Random(-300, 300)));
+		pEnd->AddDouble("Pos_Y", matrix.ty + Twips(Random(-300, 300)));
+		MockDictionary* pEase = pMotion->AddLevel("Property_Ease");
+		pEase->AddDouble("Ease_Strength", 0);
+		pEase->AddString("Ease_Type", "none");
+
+		MockDictionary* pRotation = pTween->AddLevel("Rotation_Z");
+		pStates = pRotation->AddLevel("Property_States");
+		pStates->AddDouble("Start_Value", 0);
+		pStates->AddDouble("End_Value", Twips(Random(-180, 180)));
+		pEase = pRotation->AddLevel("Property_Ease");
+		pEase->AddDouble("Ease_Strength", -50);
+		pEase->AddString("Ease_Type", "quadratic");
+
+		return static_cast<FCM::IFCMDictionary*>(pTween);
+	}
+
+	// The stage places instances of the symbols on one key frame, for the
+	// tweens to be read from
+	void SyntheticDocument::CreateStage()
+	{
+		MockTimeline* pStage = CreateMock<MockTimeline>(m_pCallback);
+		MockLayer* pLayer = CreateMock<MockLayer>(m_pCallback);
+		MockFrame* pFrame = CreateMock<MockFrame>(m_pCallback);
+
+		pStage->SetName("Scene 1");
+		pLayer->SetName("Layer 1");
+		m_pStage = static_cast<ITimeline*>(pStage);
+
+		for (FCM::U_Int32 i = 0; i < m_options.stageInstances && !m_symbols.empty(); i++)
+		{
+			MockMovieClip* pMovieClip = CreateMock<MockMovieClip>(m_pCallback);
+			INSTANCE instance;
+
+			instance.symbol = i % m_symbols.size();
+			instance.matrix = Translate(Twips(Random(0, 550)), Twips(Random(0, 400)));
+			instance.pMovieClip = static_cast<IMovieClip*>(pMovieClip);
+
+			if (m_options.nameInterval > 0 && i % m_options.nameInterval == 0)
+			{
+				pMovieClip->SetName("clip" + PixiJS::Utils::ToString(i));
+			}
+
+			pMovieClip->SetDepth(i);
+			pMovieClip->SetMatrix(instance.matrix);
+			if (m_options.tweenInterval > 0 && i % m_options.tweenInterval == 0)
+			{
+				pMovieClip->AddTweenInfo(CreateTween(instance.matrix));
+			}
+
+			pFrame->AddElement(static_cast<IFrameDisplayElement*>(pMovieClip));
+			m_instances.push_back(instance);
+		}
+
+		pLayer->AddKeyFrame(pFrame, m_options.stageFrames > 0 ? m_options.stageFrames : 1);
+		pStage->AddLayer(pLayer);
+	}
+
+	// The shapes of a symbol are defined first, then its timeline where
+	// every other shape drifts across the frames
+	FCM::Result SyntheticDocument::PublishSymbol(Exporter::Service::ITimelineBuilderFactory* pFactory, SYMBOL& symbol)
+	{
+		FCM::AutoPtr<Exporter::Service::ITimelineBuilder> pTimelineBuilder;
+		FCM::StringRep16 pName;
+		FCM::Result res;
+
+		for (size_t i = 0; i < symbol.shapes.size(); i++)
+		{
+			res = m_pResourcePalette->AddShape(symbol.shapes[i].resourceId, symbol.shapes[i].pShape);
+			if (FCM_FAILURE_CODE(res))
+			{
+				return res;
+			}
+		}
+
+		res = pFactory->CreateTimelineBuilder(pTimelineBuilder.m_Ptr);
+		if (FCM_FAILURE_CODE(res))
+		{
+			return res;
+		}
+
+		for (FCM::U_Int32 frame = 0; frame < m_options.framesPerSymbol; frame++)
+		{
+			for (size_t i = 0; i < symbol.shapes.size(); i++)
+			{
+				FCM::U_Int32 objectId = (FCM::U_Int32)i + 1;
+
+				if (frame == 0)
+				{
+					Exporter::Service::SHAPE_INFO info;
+					info.structSize = sizeof(info);
+					info.resourceId = symbol.shapes[i].resourceId;
+					info.placeAfterObjectId = (FCM::U_Int32)i;
+					info.matrix = Translate(i * 10, 0);
+					pTimelineBuilder->AddShape(objectId, &info);
+				}
+				else if (i % 2 == 0)
+				{
+					pTimelineBuilder->UpdateDisplayTransform(objectId, Translate(i * 10 + frame * 2.5, frame * 1.5));
+				}
+			}
+			pTimelineBuilder->ShowFrame();
+		}
+
+		res = ToString16(symbol.name.c_str(), pName);
+		if (FCM_FAILURE_CODE(res))
+		{
+			return res;
+		}
+
+		res = m_pResourcePalette->AddSymbol(symbol.resourceId, pName, pTimelineBuilder);
+		free(pName);
+
+		return res;
+	}
+
+	// Instances move in straight lines, and the tweened ones are read
+	// from the stage timeline
+	FCM::Result SyntheticDocument::PublishStage(Exporter::Service::ITimelineBuilderFactory* pFactory)
+	{
+		FCM::AutoPtr<Exporter::Service::ITimelineBuilder> pTimelineBuilder;
+		PixiJS::ITimelineWriter* pTimelineWriter;
+		FCM::Result res;
+
+		res = pFactory->CreateTimelineBuilder(pTimelineBuilder.m_Ptr);
+		if (FCM_FAILURE_CODE(res))
+		{
+			return res;
+		}
+
+		for (FCM::U_Int32 frame = 0; frame < m_options.stageFrames; frame++)
+		{
+			for (size_t i = 0; i < m_instances.size(); i++)
+			{
+				INSTANCE& instance = m_instances[i];
+				FCM::U_Int32 objectId = (FCM::U_Int32)i + 1;
+
+				if (frame == 0)
+				{
+					Exporter::Service::MOVIE_CLIP_INFO info;
+					info.structSize = sizeof(info);
+					info.resourceId = m_symbols[instance.symbol].resourceId;
+					info.placeAfterObjectId = (FCM::U_Int32)i;
+					info.matrix = instance.matrix;
+					pTimelineBuilder->AddMovieClip(objectId, &info, instance.pMovieClip);
+				}
+				else if (i % 3 != 2)
+				{
+					pTimelineBuilder->UpdateDisplayTransform(objectId,
+						Translate(instance.matrix.tx + frame * (i % 5 + 1), instance.matrix.ty - frame * (i % 3)));
+				}
+			}
+			pTimelineBuilder->ShowFrame();
+		}
+
+		return static_cast<PixiJS::TimelineBuilder*>(pTimelineBuilder.m_Ptr)->Build(0, NULL, &pTimelineWriter);
+	}
+
+	FCM::Result SyntheticDocument::Publish(const PUBLISH_OPTIONS& options, PUBLISH_TIMES& times)
+	{
+		FCM::AutoPtr<Exporter::Service::ITimelineBuilderFactory> pTimelineBuilderFactory;
+		FCM::Result res;
+
+		std::string basePath = options.outputDir;
+		std::string outputFile = options.outputFile;
+		std::string imagesPath("images/");
+		std::string soundsPath("sounds/");
+		std::string libsPath("libs/");
+		std::string nameSpace("lib");
+		std::string outputVersion;
+		std::string outputFormat("es6");
+		std::string stageName;
+		std::string htmlPath;
+
+		PixiJS::Utils::GetJavaScriptName(outputFile, stageName);
+		htmlPath = stageName + ".html";
+
+		res = PixiJS::Utils::CreateDir(basePath, m_pCallback);
+		if (FCM_FAILURE_CODE(res))
+		{
+			return res;
+		}
+
+		PixiJS::Utils::SetPrecision(PixiJS::PATH_PRECISION, options.pathPrecision);
+		PixiJS::Utils::SetPrecision(PixiJS::MATRIX_PRECISION, MAX_PRECISION);
+		PixiJS::Utils::SetPrecision(PixiJS::COLOR_PRECISION, MAX_PRECISION);
+		PixiJS::Utils::SetPrecision(PixiJS::ALPHA_PRECISION, MAX_PRECISION);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		PixiJS::TweenWriter tweenWriter(m_pCallback);
+
+		std::unique_ptr<PixiJS::OutputWriter> outputWriter(new PixiJS::OutputWriter(m_pCallback,
+			basePath,
+			outputFile,
+			imagesPath,
+			soundsPath,
+			htmlPath,
+			libsPath,
+			stageName,
+			nameSpace,
+			outputVersion,
+			outputFormat,
+			false,
+			false,
+			false,
+			false,
+			options.compactShapes,
+			options.packShapes,
+			options.shapeGrid,
+			true,
+			true,
+			false,
+			0,
+			1,
+			false,
+			false,
+			false,
+			"",
+			false,
+			false,
+			0,
+			options.tweenMoves));
+
+		if (!m_pResourcePalette)
+		{
+			res = m_pCallback->CreateInstance(
+				NULL,
+				PixiJS::CLSID_ResourcePalette,
+				Exporter::Service::IID_IResourcePalette,
+				(void**)&m_pResourcePalette);
+			if (FCM_FAILURE_CODE(res))
+			{
+				return res;
+			}
+		}
+
+		res = m_pCallback->CreateInstance(
+			NULL,
+			PixiJS::CLSID_TimelineBuilderFactory,
+			Exporter::Service::IID_ITimelineBuilderFactory,
+			(void**)&pTimelineBuilderFactory);
+		if (FCM_FAILURE_CODE(res))
+		{
+			return res;
+		}
+
+		PixiJS::ResourcePalette* pResPalette = static_cast<PixiJS::ResourcePalette*>(m_pResourcePalette.m_Ptr);
+		pResPalette->Clear();
+		pResPalette->Init(outputWriter.get(), options.instanceShapes);
+
+		static_cast<PixiJS::TimelineBuilderFactory*>(pTimelineBuilderFactory.m_Ptr)->Init(
+			outputWriter.get(),
+			pResPalette);
+
+		DOM::Utils::COLOR color;
+		color.red = 255;
+		color.green = 255;
+		color.blue = 255;
+		color.alpha = 255;
+
+		res = outputWriter->StartDocument(color, 400, 550, 30);
+		if (FCM_FAILURE_CODE(res))
+		{
+			return res;
+		}
+
+		for (size_t i = 0; i < m_symbols.size(); i++)
+		{
+			res = PublishSymbol(pTimelineBuilderFactory, m_symbols[i]);
+			if (FCM_FAILURE_CODE(res))
+			{
+				return res;
+			}
+		}
+
+		res = PublishStage(pTimelineBuilderFactory);
+		if (FCM_FAILURE_CODE(res))
+		{
+			return res;
+		}
+
+		tweenWriter.ReadTimeline(m_pStage, stageName);
+		outputWriter->AddTweens(tweenWriter.GetRoot());
+
+		times.build = Seconds(start);
+		start = std::chrono::steady_clock::now();
+
+		res = outputWriter->EndDocument();
+
+		times.endDocument = Seconds(start);
+
+		return res;
+	}
+};
@@ -0,0 +1,97 @@
+//
+//  copyfile.cpp
+//  PixiAnimate Harness
+//
+//  Copies files and folders for the plugin the way copyfile does on the
+//  Mac, without keeping the extended attributes or cloning.
+//
+
+#include "copyfile.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <string>
+
+static int CopyData(const char* from, const char* to)
+{
+	FILE* src = fopen(from, "rb");
+	if (src == NULL)
+	{
+		return -1;
+	}
+
+	FILE* dst = fopen(to, "wb");
+	if (dst == NULL)
+	{
+		fclose(src);
+		return -1;
+	}
+
+	char buffer[64 * 1024];
+	size_t count;
+	int res = 0;
+	while ((count = fread(buffer, 1, sizeof(buffer), src)) > 0)
+	{
+		if (fwrite(buffer, 1, count, dst) != count)
+		{
+			res = -1;
+			break;
+		}
+	}
+
+	fclose(src);
+	if (fclose(dst) != 0)
+	{
+		res = -1;
+	}
+	return res;
+}
+
+int copyfile(const char* from, const char* to, copyfile_state_t state, unsigned int flags)
+{
+	struct stat info;
+	if (stat(from, &info) != 0)
+	{
+		return -1;
+	}
+
+	if (!S_ISDIR(info.st_mode))
+	{
+		return CopyData(from, to);
+	}
+
+	if ((flags & COPYFILE_RECURSIVE) == 0)
+	{
+		return -1;
+	}
+
+	mkdir(to, 0755);
+
+	DIR* dir = opendir(from);
+	if (dir == NULL)
+	{
+		return -1;
+	}
+
+	int res = 0;
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL)
+	{
+		if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+		{
+			continue;
+		}
+
+		std::string src = std::string(from) + "/" + entry->d_name;
+		std::string dst = std::string(to) + "/" + entry->d_name;
+		if (copyfile(src.c_str(), dst.c_str(), state, flags) != 0)
+		{
+			res = -1;
+		}
+	}
+
+	closedir(dir);
+	return res;
+}
@@ -0,0 +1,125 @@
+"use strict";
+
+/**
+ * Decode the quantised shapes written by PixiAnimatePathRoundTrip and check
+ * every point is within half a grid step of the same point published as
+ * absolute values, for JSON deltas and packed varints
+ *
+ * node PathRoundTrip.js [output folder]
+ */
+const fs = require('fs');
+const path = require('path');
+const DataUtils = require('../../extension/publish/utils/DataUtils');
+
+const folder = process.argv[2] || 'roundtrip_output';
+
+function load(name)
+{
+    return JSON.parse(fs.readFileSync(path.join(folder, name + '.json'), 'utf8'));
+}
+
+const absolute = load('absolute');
+const failures = [];
+let points = 0;
+let farStarts = 0;
+
+function fail(message)
+{
+    if (failures.length < 20)
+    {
+        failures.push(message);
+    }
+}
+
+function compare(name, data, decode)
+{
+    const grid = data._meta.shapeGrid;
+    if (!grid)
+    {
+        fail(`${name}: no _meta.shapeGrid`);
+        return;
+    }
+    // Allow for the absolute values being rounded when written
+    const tolerance = grid / 2 + 1e-5;
+
+    if (data.Shapes.length != absolute.Shapes.length)
+    {
+        fail(`${name}: ${data.Shapes.length} shapes, expected ${absolute.Shapes.length}`);
+        return;
+    }
+    data.Shapes.forEach(function(shape, i)
+    {
+        const expectedShape = absolute.Shapes[i];
+        // Repeated shapes point at the first copy instead of having paths
+        if (shape.alias !== undefined || expectedShape.alias !== undefined)
+        {
+            if (shape.alias !== expectedShape.alias)
+            {
+                fail(`${name}: shape ${i} is an alias of ${shape.alias}, expected ${expectedShape.alias}`);
+            }
+            return;
+        }
+        if (shape.paths.length != expectedShape.paths.length)
+        {
+            fail(`${name}: shape ${i} has ${shape.paths.length} paths, expected ${expectedShape.paths.length}`);
+            return;
+        }
+        shape.paths.forEach(function(p, j)
+        {
+            // Each path is decoded on its own, which only works if the deltas
+            // start again from the origin at every fill or stroke
+            const commands = decode(p.d, grid);
+            const expected = expectedShape.paths[j].d;
+            const where = `${name}: shape ${i} path ${j}`;
+
+            if (commands.length != expected.length)
+            {
+                fail(`${where} has ${commands.length} commands, expected ${expected.length}`);
+                return;
+            }
+            for (let k = 0; k < expected.length; k++)
+            {
+                if (typeof expected[k] != "number")
+                {
+                    if (commands[k] !== expected[k])
+                    {
+                        fail(`${where} command ${k} is ${commands[k]}, expected ${expected[k]}`);
+                    }
+                    continue;
+                }
+                points++;
+                if (Math.abs(commands[k] - expected[k]) > tolerance)
+                {
+                    fail(`${where} value ${k} is ${commands[k]}, expected ${expected[k]} within ${tolerance}`);
+                }
+            }
+            // The first point of a later path is far from the last point of
+            // the one before, so a missed reset shows up as a large error
+            if (j > 0 && Math.abs(expected[1]) > grid * 10)
+            {
+                farStarts++;
+            }
+        });
+    });
+}
+
+compare('grid', load('grid'), function(d, grid)
+{
+    return DataUtils.undeltaPath(d.slice(), grid);
+});
+compare('packed', load('packed'), function(d, grid)
+{
+    return DataUtils.decodePath(d, grid);
+});
+
+if (!farStarts)
+{
+    fail('no path started away from the origin, the reset is not covered');
+}
+
+if (failures.length)
+{
+    console.error(failures.join('\n'));
+    process.exit(1);
+}
+console.log(`${points} values within half a grid step, ${farStarts} paths started after another`);
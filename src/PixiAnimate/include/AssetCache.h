@@ -0,0 +1,79 @@
+//
+//  AssetCache.h
+//  PixiAnimate.mp
+//
+//  Remembers the bitmaps exported by earlier publishes of a document, so
+//  files already on disk don't have to be exported again while the saved
+//  document is unchanged.
+//
+
+#ifndef ASSET_CACHE_H_
+#define ASSET_CACHE_H_
+
+#include "FCMTypes.h"
+#include "FCMPluginInterface.h"
+#include <string>
+#include <map>
+
+namespace PixiJS
+{
+	class AssetCache
+	{
+	public:
+
+		AssetCache(FCM::PIFCMCallback pCallback);
+
+		// Read the records of a document, the key is any string unique
+		// to the document such as its output data file. The records are
+		// dropped when the document file has changed since they were
+		// written, and none are kept for a document that isn't saved
+		void Load(const std::string& documentKey, const std::string& documentPath);
+
+		// Check that a library item was exported before with the same
+		// signature, and that the file written then is still unchanged
+		bool IsCurrent(
+			const std::string& libPathName,
+			const std::string& signature,
+			const std::string& exportPath);
+
+		// Record the file just exported for a library item
+		void Update(
+			const std::string& libPathName,
+			const std::string& signature,
+			const std::string& exportPath);
+
+		// Write the records back if anything changed
+		FCM::Result Save();
+
+	private:
+
+		struct Entry
+		{
+			std::string signature;
+			std::string exportPath;
+			FCM::U_Int64 hash;
+			FCM::U_Int64 size;
+		};
+
+		bool HashFile(const std::string& path, FCM::U_Int64& hash, FCM::U_Int64& size) const;
+
+		bool HashDocument(const std::string& documentPath, FCM::U_Int64& hash) const;
+
+		FCM::PIFCMCallback m_pCallback;
+
+		std::string m_cacheFile;
+
+		// Content hash of the saved document
+		FCM::U_Int64 m_document;
+
+		// False when the document couldn't be read, nothing is reused then
+		bool m_documentKnown;
+
+		// Records by library path
+		std::map<std::string, Entry> m_entries;
+
+		bool m_dirty;
+	};
+};
+
+#endif /* ASSET_CACHE_H_ */
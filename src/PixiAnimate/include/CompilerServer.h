@@ -0,0 +1,60 @@
+//
+//  CompilerServer.h
+//  PixiAnimate.mp
+//
+//  Keeps one compiler process running for the whole session and sends
+//  it each publish over a local port, so Electron only starts once.
+//
+
+#ifndef COMPILER_SERVER_H_
+#define COMPILER_SERVER_H_
+
+#include "FCMTypes.h"
+#include "FCMPluginInterface.h"
+#include <string>
+
+namespace PixiJS
+{
+	class Process;
+
+	class CompilerServer
+	{
+	public:
+
+		// The server shared by every publish in this session
+		static CompilerServer& GetInstance();
+
+		// Compile a data file on the running compiler, which is started or
+		// restarted first when it doesn't answer. Fails only when the
+		// request could not be sent, the caller should then run the
+		// compiler on its own.
+		FCM::Result Compile(
+			const std::string& compiler,
+			const std::string& dataFile,
+			bool debug,
+			FCM::PIFCMCallback pCallback);
+
+		// End the compiler process
+		void Stop();
+
+	private:
+
+		CompilerServer();
+
+		~CompilerServer();
+
+		FCM::Result Start(const std::string& compiler, FCM::PIFCMCallback pCallback);
+
+		// Check that the compiler answers on its port
+		bool Ping();
+
+		std::string m_compiler;
+
+		int m_port;
+
+		// The compiler quits when its input is closed
+		Process* m_pProcess;
+	};
+};
+
+#endif /* COMPILER_SERVER_H_ */
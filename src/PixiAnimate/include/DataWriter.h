@@ -0,0 +1,139 @@
+//
+//  DataWriter.h
+//  PixiAnimate.mp
+//
+//  Streams the publish data document to disk one asset at a time so
+//  that the size of the document never has to fit in memory.
+//
+
+#ifndef JSON_DATA_WRITER_H_
+#define JSON_DATA_WRITER_H_
+
+#include "FCMTypes.h"
+#include "FCMPluginInterface.h"
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class JSONNode;
+
+namespace PixiJS
+{
+	class SizeReport;
+
+	class DataWriter
+	{
+	public:
+
+		// The top-level arrays of the data document, in output order
+		enum Section
+		{
+			SHAPES = 0,
+			BITMAPS,
+			SOUNDS,
+			TEXTS,
+			TIMELINES,
+			TWEENS,
+			FILL_STYLES,
+			STROKE_STYLES,
+			GRADIENTS,
+			SECTION_COUNT
+		};
+
+		DataWriter(const std::string& outputFile, FCM::PIFCMCallback pCallback);
+
+		~DataWriter();
+
+		// Write the document into a stream instead of the output file, set
+		// before Open. The first section goes into it as it is written, the
+		// others are buffered until Close. The stream is not closed here.
+		void SetStream(FILE* pStream);
+
+		// Count the bytes and serializing time of each entry by asset id
+		void SetSizeReport(SizeReport* pSizeReport);
+
+		// Create the buffered section files next to the output file
+		FCM::Result Open();
+
+		// Serialize a finished node and append it to a section
+		void Write(Section section, const JSONNode& node, FCM::U_Int32 assetId = 0);
+
+		// Append an already serialized entry to a section
+		void Write(Section section, const std::string& json, FCM::U_Int32 assetId = 0);
+
+		// Serialize a node on a worker thread and append it to a section.
+		// Takes ownership of the node, which must not share its internals
+		// with any other node (pass a duplicate). Entries still land in
+		// the order they were written.
+		void WriteAsync(Section section, JSONNode* pNode, FCM::U_Int32 assetId = 0);
+
+		// Join the sections into the output file and end it with the meta node
+		FCM::Result Close(const JSONNode& meta);
+
+	private:
+
+		// An entry waiting for its turn to be appended
+		struct Job
+		{
+			Section section;
+			JSONNode* pNode;
+			FCM::U_Int32 assetId;
+			std::string json;
+			bool taken;
+			bool done;
+		};
+
+		std::string GetSectionFile(Section section) const;
+
+		void Append(Section section, const std::string& json);
+
+		FCM::Result CloseStream(const JSONNode& meta);
+
+		// Append the finished jobs at the front of the queue, call locked
+		void Flush();
+
+		void Worker();
+
+		void StartWorkers();
+
+		void StopWorkers();
+
+		void Discard();
+
+		std::string m_outputFile;
+
+		FCM::PIFCMCallback m_pCallback;
+
+		std::fstream m_sections[SECTION_COUNT];
+
+		bool m_sectionEmpty[SECTION_COUNT];
+
+		bool m_open;
+
+		FILE* m_pStream;
+
+		SizeReport* m_pSizeReport;
+
+		std::vector<std::thread> m_workers;
+
+		// Jobs in write order, the front one is appended first
+		std::deque<Job*> m_jobs;
+
+		std::mutex m_mutex;
+
+		// Signalled when a job is queued or the workers should stop
+		std::condition_variable m_jobQueued;
+
+		// Signalled when the queue drains
+		std::condition_variable m_jobsDone;
+
+		bool m_stopping;
+	};
+};
+
+#endif /* JSON_DATA_WRITER_H_ */
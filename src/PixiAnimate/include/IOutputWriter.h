@@ -267,7 +267,8 @@ namespace PixiJS
 			FCM::U_Int32 objectId,
 			FCM::U_Int32 placeAfterObjectId,
 			const DOM::Utils::MATRIX2D* pMatrix,
-			const DOM::Utils::RECT* pRect = NULL) = 0;
+			const DOM::Utils::RECT* pRect = NULL,
+			const DOM::Utils::MATRIX2D* pMapAtoB = NULL) = 0;
 
 		virtual FCM::Result PlaceObject(
 			FCM::U_Int32 resId,
@@ -13,6 +13,10 @@
 #include "FCMTypes.h"
 #include "IOutputWriter.h"
 #include "Utils.h"
+#include "DataWriter.h"
+#include "PathEncoder.h"
+#include "AssetCache.h"
+#include "SizeReport.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -23,6 +27,17 @@ class JSONNode;
 
 namespace PixiJS
 {
+	// A shape exported with its paths, m_shapeMap keeps this instead of the
+	// paths themselves
+	struct SHAPE_DIGEST
+	{
+		FCM::U_Int32 resId;
+
+		// Length and Utils::CheckHash of the serialized paths
+		size_t size;
+		FCM::U_Int64 check;
+	};
+
 	class OutputWriter : public IOutputWriter
 	{
 	public:
@@ -188,11 +203,21 @@ namespace PixiJS
 			bool images,
 			bool sounds,
 			bool compactShapes,
+			bool packShapes,
+			double shapeGrid,
 			bool compressJS,
 			bool loopTimeline,
 			bool spritesheets,
 			int spritesheetSize,
-			double spritesheetScale);
+			double spritesheetScale,
+			bool streamData,
+			bool compilerServer,
+			bool assetCache,
+			const std::string& documentPath,
+			bool browserPreview,
+			bool sizeReport,
+			int seekInterval,
+			bool tweenMoves);
 
 		virtual ~OutputWriter();
 
@@ -210,25 +235,59 @@ namespace PixiJS
 
 	private:
 
-		FCM::Boolean GetImageExportFileName(const std::string& libPathName, std::string& name);
+		// Export a bitmap to the images folder once per publish, later uses
+		// of the same library item get the file written the first time
+		FCM::Result ExportBitmap(
+			const std::string& libPathName,
+			DOM::LibraryItem::PIMediaItem pMediaItem,
+			FCM::S_Int32 width,
+			FCM::S_Int32 height,
+			std::string& name,
+			std::string& fileName);
 
-		void SetImageExportFileName(const std::string& libPathName, const std::string& name);
+		FCM::Boolean GetImageExportFileName(const std::string& libPathName, std::string& fileName);
 
-		void Save(const std::string &filePath, const std::string &content);
+		void SetImageExportFileName(const std::string& libPathName, const std::string& fileName);
 
-		bool SaveFromTemplate(const std::string &templatePath, const std::string &outputPath);
+		// Begin the drawing commands of a fill or stroke
+		void StartPathCommands();
 
-		JSONNode* m_pRootNode;
+		// Add a drawing command to the current path
+		void AddPathCommand(PathEncoder::Command command, const std::string& key);
 
-		JSONNode* m_pShapeArray;
+		// Add a point to the current path
+		void AddPathPoint(const DOM::Utils::POINT2D& point);
 
-		JSONNode* m_pTimelineArray;
+		// Add the drawing commands to the fill or stroke
+		void EndPathCommands();
 
-		JSONNode* m_pBitmapArray;
+		// Add the time since start to an asset in the size report
+		void AddDefineTime(DataWriter::Section section, FCM::U_Int32 assetId, FCM::U_Int64 start);
 
-		JSONNode* m_pSoundArray;
+		// Get the index of a style in a document style table, the style
+		// is written to the table the first time it is seen
+		FCM::U_Int32 AddStyle(
+			DataWriter::Section section,
+			std::map<std::string, FCM::U_Int32>& table,
+			const JSONNode& style);
 
-		JSONNode* m_pTextArray;
+		// Reference a fill style from the current fill or stroke
+		void SetFillStyle(const JSONNode& style);
+
+		void Save(const std::string &filePath, const std::string &content);
+
+		bool SaveFromTemplate(const std::string &templatePath, const std::string &outputPath);
+
+		// Path to the compiler script in the extension
+		std::string GetCompilerPath() const;
+
+		// Arguments to run the compiler on the data file
+		std::string GetCompilerArgs() const;
+
+		DataWriter* m_pDataWriter;
+
+		// Compiler reading its input when the data is streamed to it
+		Process* m_pCompiler;
 
 		JSONNode* m_pTweenArray;
 
@@ -252,6 +311,13 @@ namespace PixiJS
 
 		JSONNode*  m_pathCmdArray;
 
+		PathEncoder m_pathEncoder;
+
+		// The last quantised point of the path, in grid units
+		FCM::S_Int32 m_lastGridX;
+
+		FCM::S_Int32 m_lastGridY;
+
 		bool       m_firstSegment;
 
 		FCM::U_Int32 m_framerate;
@@ -266,8 +332,45 @@ namespace PixiJS
 
 		FCM::PIFCMCallback m_pCallback;
 
+		// Exported image file, by library path
 		std::map<std::string, std::string> m_imageMap;
 
+		// Bitmap uses served from m_imageMap instead of a new export
+		FCM::U_Int32 m_bitmapExportsAvoided;
+
+		// Bitmaps kept from earlier publishes, NULL when not enabled
+		AssetCache* m_pAssetCache;
+
+		FCM::U_Int32 m_cachedBitmapCount;
+
+		// Cost of each asset, NULL when not enabled
+		SizeReport* m_pSizeReport;
+
+		// When the shape or text being defined was started
+		FCM::U_Int64 m_defineStart;
+
+		FCM::U_Int32 m_pathSegmentCount;
+
+		FCM::U_Int32 m_textId;
+
+		// Style tables, by serialized style
+		std::map<std::string, FCM::U_Int32> m_fillStyles;
+
+		std::map<std::string, FCM::U_Int32> m_strokeStyles;
+
+		std::map<std::string, FCM::U_Int32> m_gradients;
+
+		// The shapes exported with their own paths, by Utils::Hash of the
+		// serialized paths. Shapes whose paths collide share the key.
+		std::multimap<FCM::U_Int64, SHAPE_DIGEST> m_shapeMap;
+
+		FCM::U_Int32 m_dedupShapeCount;
+
+		// Frame commands left out of the timelines as they changed nothing
+		FCM::U_Int32 m_deadCommandCount;
+
+		FCM::U_Int64 m_dedupShapeBytes;
+
 		FCM::U_Int32 m_symbolNameLabel;
 
 		FCM::Boolean m_imageFolderCreated;
@@ -318,9 +421,28 @@ namespace PixiJS
 
 		bool m_compactShapes;
 
+		bool m_packShapes;
+
+		// Size in pixels to quantise shape points to, 0 writes them unchanged
+		double m_shapeGrid;
+
 		bool m_compressJS;
 
 		bool m_loopTimeline;
+
+		bool m_streamData;
+
+		// Publish through the compiler kept running for the session
+		bool m_compilerServer;
+
+		// Preview in a browser served by the plugin, instead of the preview app
+		bool m_browserPreview;
+
+		// Frames between the display list snapshots of each timeline, 0 for none
+		FCM::U_Int32 m_seekInterval;
+
+		// Collapse straight runs of Move commands into tweens
+		bool m_tweenMoves;
 	};
 };
 
@@ -0,0 +1,65 @@
+//
+//  PathEncoder.h
+//  PixiAnimate.mp
+//
+//  Packs the drawing commands of a shape path into a byte stream,
+//  used instead of a JSON array when packed shapes are enabled.
+//
+
+#ifndef JSON_PATH_ENCODER_H_
+#define JSON_PATH_ENCODER_H_
+
+#include <string>
+#include <vector>
+
+namespace PixiJS
+{
+	class PathEncoder
+	{
+	public:
+
+		// Opcodes written to the stream, must match DataUtils.decodePath
+		enum Command
+		{
+			MOVE_TO = 0,
+			LINE_TO,
+			QUADRATIC_CURVE_TO,
+			CLOSE_PATH,
+			BEGIN_HOLE,
+			END_HOLE
+		};
+
+		PathEncoder();
+
+		// Start a new path
+		void Clear();
+
+		// Add a drawing command, the points follow with AddPoint
+		void AddCommand(Command command);
+
+		// Add a point as two little-endian Float32 values
+		void AddPoint(double x, double y);
+
+		// Add a quantised point, as the distance in grid units from the
+		// previous point, written as two zig-zag varints
+		void AddPointDelta(int dx, int dy);
+
+		// Get the packed stream as base64
+		std::string ToBase64() const;
+
+	private:
+
+		void WriteFloat(float value);
+
+		void WriteVarint(int value);
+
+		void FlushMove();
+
+		std::vector<unsigned char> m_buffer;
+
+		// The move command is held until its point arrives
+		bool m_pendingMove;
+	};
+};
+
+#endif /* JSON_PATH_ENCODER_H_ */
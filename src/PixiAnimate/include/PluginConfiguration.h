@@ -55,6 +55,9 @@
 /* Electron application to run preview */
 #define PREVIEW_APP                         "preview";
 
+/* Time to wait for electron to report its version, in milliseconds */
+#define ELECTRON_CHECK_TIMEOUT              30000
+
 namespace PixiJS
 {
 	// {d30f8a0d-8234-44e1-9e30-ee48b415be9d}
@@ -0,0 +1,92 @@
+//
+//  PreviewServer.h
+//  PixiAnimate.mp
+//
+//  Serves the published output to a browser on a local port, and tells
+//  the open pages to reload when the output is published again.
+//
+
+#ifndef PREVIEW_SERVER_H_
+#define PREVIEW_SERVER_H_
+
+#ifdef USE_HTTP_SERVER
+
+#ifdef _WINDOWS
+#include <WinSock.h>
+#endif
+
+#include "FCMTypes.h"
+#include "FCMPluginInterface.h"
+#include "Utils.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace PixiJS
+{
+	class PreviewServer
+	{
+	public:
+
+		// The server shared by every publish in this session
+		static PreviewServer& GetInstance();
+
+		// Serve a folder, starting the server if needed. Returns false
+		// when no page is open on the folder yet.
+		bool Serve(const std::string& rootFolder, FCM::PIFCMCallback pCallback);
+
+		// Tell the pages open on a folder to reload
+		void Reload(const std::string& rootFolder);
+
+		// Stop serving and close the open pages' connections
+		void Stop();
+
+		int GetPort() const;
+
+	private:
+
+		PreviewServer();
+
+		~PreviewServer();
+
+		void Listen();
+
+		void HandleConnection(SOCKET sock);
+
+		void ServeFile(SOCKET sock, const std::string& path, const std::string& request, bool head);
+
+		// Forget the pages that closed their connection, call locked
+		void PruneClients();
+
+		std::string GetRoot();
+
+		std::string m_root;
+
+		int m_port;
+
+		SOCKET m_listenSocket;
+
+		std::thread m_listener;
+
+		std::atomic<bool> m_stopping;
+
+		// Pages waiting for a reload event
+		std::vector<SOCKET> m_clients;
+
+		// Connections being answered
+		int m_activeCount;
+
+		std::mutex m_mutex;
+
+		std::condition_variable m_connectionDone;
+
+		FCM::PIFCMCallback m_pCallback;
+	};
+};
+
+#endif // USE_HTTP_SERVER
+
+#endif /* PREVIEW_SERVER_H_ */
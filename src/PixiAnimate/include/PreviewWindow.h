@@ -0,0 +1,48 @@
+//
+//  PreviewWindow.h
+//  PixiAnimate.mp
+//
+//  Keeps track of the preview app started by the plugin, so publishing
+//  again reloads that window instead of starting a new one.
+//
+
+#ifndef PREVIEW_WINDOW_H_
+#define PREVIEW_WINDOW_H_
+
+#include "FCMTypes.h"
+#include "FCMPluginInterface.h"
+#include <string>
+
+namespace PixiJS
+{
+	class Process;
+
+	class PreviewWindow
+	{
+	public:
+
+		// The preview shared by every publish in this session
+		static PreviewWindow& GetInstance();
+
+		// Reload the open preview when it shows the same output with the
+		// same arguments, otherwise close it and start a new one
+		FCM::Result Show(const std::string& args, FCM::PIFCMCallback pCallback);
+
+		// Close the preview started by the plugin, if it is still open
+		void Stop();
+
+	private:
+
+		PreviewWindow();
+
+		~PreviewWindow();
+
+		std::string m_args;
+
+		int m_port;
+
+		Process* m_pProcess;
+	};
+};
+
+#endif /* PREVIEW_WINDOW_H_ */
@@ -0,0 +1,99 @@
+//
+//  Process.h
+//  PixiAnimate.mp
+//
+//  Starts a child process without going through a shell, with optional
+//  pipes to its input and from its output, and ends it with its children.
+//
+
+#ifndef PROCESS_H_
+#define PROCESS_H_
+
+#include <string>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#ifdef _WINDOWS
+#include "Windows.h"
+#else
+#include <sys/types.h>
+#endif
+
+namespace PixiJS
+{
+	class Process
+	{
+	public:
+
+		enum Flags
+		{
+			// Open a stream to the standard input, see GetInput
+			PIPE_INPUT = 1,
+
+			// Keep the standard output and error, see GetOutput
+			CAPTURE_OUTPUT = 2
+		};
+
+		Process();
+
+		// Kills the process if it is still running and wasn't detached
+		~Process();
+
+		// Start a program, the arguments are split like a command line
+		// with double quotes around arguments that contain spaces
+		bool Start(const std::string& program, const std::string& args, int flags);
+
+		// Stream to the standard input, NULL without PIPE_INPUT
+		FILE* GetInput() const;
+
+		// Close the standard input, the process sees the end of its input
+		void CloseInput();
+
+		// Wait for the process to exit, a timeout of 0 waits as long as it
+		// takes. Returns false if it is still running after the timeout.
+		bool Wait(int timeoutMs, int& exitCode);
+
+		// End the process and everything it started
+		void Kill();
+
+		// Let the process run on after this object is gone, only for a
+		// process started without CAPTURE_OUTPUT
+		void Detach();
+
+		// The last of the standard output and error, once the process exited
+		std::string GetOutput();
+
+	private:
+
+		void ReadOutput();
+
+		void Close();
+
+		FILE* m_pInput;
+
+		std::thread m_reader;
+
+		std::mutex m_mutex;
+
+		std::string m_output;
+
+		bool m_running;
+
+#ifdef _WINDOWS
+		HANDLE m_hProcess;
+
+		// Holds the process and its children so they can be ended together
+		HANDLE m_hJob;
+
+		HANDLE m_hOutput;
+#else
+		// Also the id of its process group
+		pid_t m_pid;
+
+		int m_outputFd;
+#endif
+	};
+};
+
+#endif /* PROCESS_H_ */
@@ -0,0 +1,106 @@
+//
+//  Profiler.h
+//  PixiAnimate.mp
+//
+//  Times the phases of a publish, writes them as a trace that can be
+//  opened in chrome://tracing and summarizes them in the publish log.
+//
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include "FCMTypes.h"
+#include "FCMPluginInterface.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace PixiJS
+{
+	class Profiler
+	{
+	public:
+
+		// The profiler shared by every publish in this session
+		static Profiler& GetInstance();
+
+		// Forget the phases of the last publish and record the next ones
+		// when enabled
+		void Start(bool enabled);
+
+		bool IsEnabled() const;
+
+		// Stop recording, write the trace file and log the slowest phases
+		// and symbols
+		FCM::Result Finish(const std::string& traceFile, FCM::PIFCMCallback pCallback);
+
+		// Microseconds since Start
+		FCM::U_Int64 Now() const;
+
+		// Keep a finished phase, the symbol is empty when the phase is not
+		// about a single symbol
+		void Record(const char* name, const std::string& symbol, FCM::U_Int64 start, FCM::U_Int64 duration);
+
+	private:
+
+		struct Event
+		{
+			const char* name;
+			std::string symbol;
+			FCM::U_Int64 start;
+			FCM::U_Int64 duration;
+			FCM::U_Int32 thread;
+		};
+
+		struct Total
+		{
+			FCM::U_Int64 duration;
+			FCM::U_Int32 count;
+		};
+
+		Profiler();
+
+		void LogTotals(const std::map<std::string, Total>& totals, const char* title,
+			FCM::U_Int32 maxCount, FCM::PIFCMCallback pCallback);
+
+		std::atomic<bool> m_enabled;
+
+		std::chrono::steady_clock::time_point m_startTime;
+
+		std::vector<Event> m_events;
+
+		// Small numbers for the threads, in the order they first recorded
+		std::map<std::thread::id, FCM::U_Int32> m_threads;
+
+		std::mutex m_mutex;
+	};
+
+	// Times the enclosing block when the profiler is recording
+	class ProfileScope
+	{
+	public:
+
+		// The name must outlive the publish, use a literal
+		ProfileScope(const char* name);
+
+		ProfileScope(const char* name, const std::string& symbol);
+
+		~ProfileScope();
+
+	private:
+
+		const char* m_name;
+
+		std::string m_symbol;
+
+		FCM::U_Int64 m_start;
+
+		bool m_enabled;
+	};
+};
+
+#endif /* PROFILER_H_ */
@@ -26,6 +26,7 @@
 #define PUBLISHER_H_
 
 #include <vector>
+#include <map>
 
 #include "Version.h"
 #include "FCMTypes.h"
@@ -39,6 +40,7 @@
 #include "FillStyle/IBitmapFillStyle.h"
 #include "FrameElement/IClassicText.h"
 #include "FrameElement/ITextStyle.h"
+#include "FrameElement/IShape.h"
 #include "Exporter/Service/IFrameCommandGenerator.h"
 #include "OutputWriter.h"
 #include "TimelineWriter.h"
@@ -94,6 +96,41 @@ namespace DOM
 
 /* -------------------------------------------------- Structs / Unions */
 
+namespace PixiJS
+{
+	// Cheap description of a shape used to find candidates for similarity
+	struct SHAPE_SIGNATURE
+	{
+		FCM::U_Int32 fillCount;
+		FCM::U_Int32 strokeCount;
+		FCM::U_Int32 edgeCount;
+
+		// Short side over long side of the bounds, quantised
+		FCM::U_Int32 aspect;
+
+		bool operator<(const SHAPE_SIGNATURE& other) const
+		{
+			if (fillCount != other.fillCount) return fillCount < other.fillCount;
+			if (strokeCount != other.strokeCount) return strokeCount < other.strokeCount;
+			if (edgeCount != other.edgeCount) return edgeCount < other.edgeCount;
+			return aspect < other.aspect;
+		}
+	};
+
+	// A shape exported as a transformed copy of another shape
+	struct SHAPE_INSTANCE
+	{
+		FCM::U_Int32 sourceId;
+		DOM::Utils::MATRIX2D mapAtoB;
+	};
+
+	// A shape exported with its own geometry
+	struct SHAPE_SOURCE
+	{
+		FCM::U_Int32 resourceId;
+		FCM::AutoPtr<DOM::FrameElement::IShape> pShape;
+	};
+}
 
 /* -------------------------------------------------- Class Decl */
 
@@ -192,7 +229,7 @@ namespace PixiJS
 
 		~ResourcePalette();
 
-		void Init(IOutputWriter* outputWriter);
+		void Init(IOutputWriter* outputWriter, bool instanceShapes);
 
 		void Clear();
 
@@ -200,6 +237,13 @@ namespace PixiJS
 			const std::string& name,
 			FCM::Boolean& hasResource);
 
+		// Get the shape and matrix to place instead of a shape that was
+		// found similar to one already exported
+		bool GetShapeInstance(
+			FCM::U_Int32 resourceId,
+			FCM::U_Int32& sourceId,
+			DOM::Utils::MATRIX2D& mapAtoB) const;
+
 	private:
 
 		FCM::Result ExportFill(DOM::FrameElement::PIShape pIShape);
@@ -240,6 +284,12 @@ namespace PixiJS
 
 		FCM::Result GetTextBehaviour(DOM::FrameElement::ITextBehaviour* pTextBehaviour, TEXT_BEHAVIOUR& textBehaviour);
 
+		FCM::Result GetShapeSignature(DOM::FrameElement::PIShape pShape, SHAPE_SIGNATURE& signature);
+
+		FCM::Result GetEdgeCount(DOM::Service::Shape::PIPath pPath, FCM::U_Int32& edgeCount);
+
+		bool FindSimilarShape(FCM::U_Int32 resourceId, DOM::FrameElement::PIShape pShape);
+
 	private:
 
 		IOutputWriter* m_outputWriter;
@@ -247,6 +297,14 @@ namespace PixiJS
 		std::vector<FCM::U_Int32> m_resourceList;
 
 		std::vector<std::string> m_resourceNames;
+
+		bool m_instanceShapes;
+
+		// Exported shapes of the current timeline that later shapes can
+		// be instances of
+		std::map<SHAPE_SIGNATURE, std::vector<SHAPE_SOURCE> > m_shapeSources;
+
+		std::map<FCM::U_Int32, SHAPE_INSTANCE> m_shapeInstances;
 	};
 
 
@@ -331,12 +389,14 @@ namespace PixiJS
 			FCM::StringRep16 name,
 			ITimelineWriter** timelineWriter);
 
-		void Init(IOutputWriter* outputWriter);
+		void Init(IOutputWriter* outputWriter, ResourcePalette* resourcePalette);
 
 	private:
 
 		IOutputWriter* m_outputWriter;
 
+		ResourcePalette* m_resourcePalette;
+
 		ITimelineWriter* m_timelineWriter;
 
 		FCM::U_Int32 m_frameIndex;
@@ -357,11 +417,13 @@ namespace PixiJS
 
 		~TimelineBuilderFactory();
 
-		void Init(IOutputWriter* outputWriter);
+		void Init(IOutputWriter* outputWriter, ResourcePalette* resourcePalette);
 
 	private:
 
 		IOutputWriter* m_outputWriter;
+
+		ResourcePalette* m_resourcePalette;
 	};
 
 	FCM::Result RegisterPublisher(PIFCMDictionary pPlugins, FCM::FCMCLSID docId);
@@ -0,0 +1,84 @@
+//
+//  SizeReport.h
+//  PixiAnimate.mp
+//
+//  Adds up what each asset costs in the data file, bytes, path segments,
+//  frame commands and export time, and writes it out biggest first.
+//
+
+#ifndef SIZE_REPORT_H_
+#define SIZE_REPORT_H_
+
+#include "FCMTypes.h"
+#include "FCMPluginInterface.h"
+#include "DataWriter.h"
+#include <string>
+#include <map>
+#include <mutex>
+
+class JSONNode;
+
+namespace PixiJS
+{
+	class SizeReport
+	{
+	public:
+
+		SizeReport(FCM::PIFCMCallback pCallback);
+
+		// Microseconds on a steady clock, to time exports with
+		static FCM::U_Int64 Now();
+
+		// The methods below are safe to call from the data writer's workers.
+		// Entries of the style and tween sections are written with an asset
+		// id of 0 and are added up per section.
+
+		void SetName(DataWriter::Section section, FCM::U_Int32 assetId, const std::string& name);
+
+		void AddBytes(DataWriter::Section section, FCM::U_Int32 assetId, FCM::U_Int64 bytes);
+
+		void AddTime(DataWriter::Section section, FCM::U_Int32 assetId, FCM::U_Int64 microseconds);
+
+		void AddPathSegments(FCM::U_Int32 shapeId, FCM::U_Int32 count);
+
+		// Add the size of an image or sound file exported for an asset
+		void AddFile(DataWriter::Section section, FCM::U_Int32 assetId, const std::string& path);
+
+		// Count the frame commands of a finished timeline by type
+		void AddCommands(FCM::U_Int32 timelineId, const JSONNode& timeline);
+
+		// Write <path>.json and a table in <path>.txt
+		FCM::Result Save(const std::string& path);
+
+	private:
+
+		struct Entry
+		{
+			std::string name;
+			FCM::U_Int64 bytes;
+			FCM::U_Int64 fileBytes;
+			FCM::U_Int64 time;
+			FCM::U_Int32 count;
+			FCM::U_Int32 pathSegments;
+			FCM::U_Int32 frames;
+			std::map<std::string, FCM::U_Int32> commands;
+		};
+
+		typedef std::pair<DataWriter::Section, FCM::U_Int32> Key;
+
+		typedef std::map<Key, Entry> EntryMap;
+
+		// Biggest first counting the exported files, the time breaks ties
+		static bool IsCostlier(EntryMap::const_iterator a, EntryMap::const_iterator b);
+
+		Entry& GetEntry(DataWriter::Section section, FCM::U_Int32 assetId);
+
+		FCM::PIFCMCallback m_pCallback;
+
+		EntryMap m_entries;
+
+		std::mutex m_mutex;
+	};
+};
+
+#endif /* SIZE_REPORT_H_ */
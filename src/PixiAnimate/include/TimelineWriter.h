@@ -12,6 +12,8 @@
 #include "IOutputWriter.h"
 #include "Utils.h"
 #include <vector>
+#include <map>
+#include <set>
 
 class JSONNode;
 
@@ -26,7 +28,8 @@ namespace PixiJS
 			FCM::U_Int32 objectId,
 			FCM::U_Int32 placeAfterObjectId,
 			const DOM::Utils::MATRIX2D* pMatrix,
-			const DOM::Utils::RECT* pRect = NULL);
+			const DOM::Utils::RECT* pRect = NULL,
+			const DOM::Utils::MATRIX2D* pMapAtoB = NULL);
 
 		virtual FCM::Result PlaceObject(
 			FCM::U_Int32 resId,
@@ -90,6 +93,16 @@ namespace PixiJS
 
 		void Finish(FCM::U_Int32 resId, FCM::StringRep16 pName, std::string name);
 
+		// Frames between the display list snapshots written by Finish,
+		// 0 for none
+		void SetSeekInterval(FCM::U_Int32 interval);
+
+		// Whether Finish collapses straight runs of Moves into tweens
+		void SetTweenMoves(bool tweenMoves);
+
+		// Commands Finish left out because they changed nothing
+		FCM::U_Int32 GetDeadCommandCount() const;
+
 
 	private:
 
@@ -99,6 +112,41 @@ namespace PixiJS
 			FCM::U_Int32 objectId,
 			FCM::U_Int32 maskTillObjectId);
 
+		// Remember the matrix an instance is placed with, NULL when none
+		void SetPlacedMatrix(FCM::U_Int32 objectId, const DOM::Utils::MATRIX2D* pMatrix);
+
+		// The components of the matrix that changed since the instance's
+		// last Place or Move, all of them the first time
+		JSONNode GetTransformDelta(FCM::U_Int32 objectId, const DOM::Utils::MATRIX2D& matrix);
+
+		// Follow the matrix just written for an instance, a Place starts
+		// a new run
+		void AddTransformPoint(FCM::U_Int32 objectId, bool isPlace);
+
+		// Stop following an instance before the current frame, on restart
+		// a matrix already written on it starts the next run
+		void EndTransformRun(FCM::U_Int32 objectId, bool restart);
+
+		// Swap the inside Moves of each straight run for a tween from its
+		// first matrix to its last
+		void CollapseTransformRuns();
+
+		// Replay the frames and keep the live instances every seek interval,
+		// so a runtime can jump to a frame without starting from frame 0
+		void AddSnapshots();
+
+		// Replay the frames and leave out the commands that change nothing,
+		// repeated states, empty Moves and instances removed where placed
+		void RemoveDeadCommands();
+
+		// Erase commands by frame index and the frames left empty
+		void EraseCommands(std::map<FCM::S_Int32, std::set<FCM::U_Int32> >& dropped);
+
+		// Count how many instances of each asset are alive at once and how
+		// many placements could take a removed one, for the assets that are
+		// placed again after a removal
+		void AddPools();
+
 
 	private:
 
@@ -119,6 +167,72 @@ namespace PixiJS
 		FCM::PIFCMCallback m_pCallback;
 
 		FCM::U_Int32 m_FrameCount;
+
+		FCM::U_Int32 m_seekInterval;
+
+		bool m_tweenMoves;
+
+		// State of an instance as its commands set it
+		struct LIVE_INSTANCE
+		{
+			JSONNode color;
+			bool visible;
+			std::string blendMode;
+		};
+
+		FCM::U_Int32 m_deadCommandCount;
+
+		// Instances of an asset over the timeline
+		struct POOL
+		{
+			FCM::U_Int32 alive;
+			FCM::U_Int32 maxAlive;
+			FCM::U_Int32 peakFrame;
+			FCM::U_Int32 placed;
+			FCM::U_Int32 free;
+			FCM::U_Int32 reused;
+			FCM::U_Int32 firstReuse;
+		};
+
+		// Objects placed as an instance of a similar shape
+		std::map<FCM::U_Int32, DOM::Utils::MATRIX2D> m_instanceMaps;
+
+		// A matrix as rounded in the output, a, b, c, d, tx and ty
+		struct WRITTEN_MATRIX
+		{
+			FCM::Double values[6];
+		};
+
+		// Last matrix written for each instance
+		std::map<FCM::U_Int32, WRITTEN_MATRIX> m_instanceMatrices;
+
+		// A matrix written on a frame, frame is the count of frames shown
+		// before it and command its index in that frame's commands
+		struct TRANSFORM_POINT
+		{
+			FCM::U_Int32 frame;
+			FCM::U_Int32 command;
+			WRITTEN_MATRIX matrix;
+		};
+
+		// Matrices of an instance on consecutive frames
+		typedef std::vector<TRANSFORM_POINT> TRANSFORM_RUN;
+
+		static bool IsLinear(const TRANSFORM_RUN& run);
+
+		void SaveTransformRun(TRANSFORM_RUN& run);
+
+		// Straight run still being written for each instance
+		std::map<FCM::U_Int32, TRANSFORM_RUN> m_transformRuns;
+
+		// Finished runs long enough to collapse
+		std::vector<TRANSFORM_RUN> m_linearRuns;
+
+		// For each frame shown, its number and its index in the frame
+		// array, -1 when it was left out
+		std::vector<FCM::U_Int32> m_frameNumbers;
+
+		std::vector<FCM::S_Int32> m_frameIndices;
 	};
 };
 
@@ -38,13 +38,17 @@
 #include "IFCMStringUtils.h"
 #include <iostream>
 #include <fstream>
+#include <cstdio>
 #include "StrokeStyle/ISolidStrokeStyle.h"
 
  /* -------------------------------------------------- Forward Decl */
 
-#ifdef USE_HTTP_SERVER
 struct sockaddr_in;
-#endif // USE_HTTP_SERVER
+
+namespace PixiJS
+{
+	class Process;
+}
 
 /* -------------------------------------------------- Enums */
 
@@ -55,6 +59,16 @@ namespace PixiJS
 		INVALID_STROKE_STYLE_TYPE,
 		SOLID_STROKE_STYLE_TYPE
 	};
+
+	// Kinds of numbers written with their own number of decimals
+	enum PrecisionCategory
+	{
+		PATH_PRECISION = 0,
+		MATRIX_PRECISION,
+		COLOR_PRECISION,
+		ALPHA_PRECISION,
+		PRECISION_COUNT
+	};
 }
 
 /* -------------------------------------------------- Structs / Unions */
@@ -111,7 +125,6 @@ namespace PixiJS
 #define LOG(x)
 #endif
 
-#ifdef USE_HTTP_SERVER
 #ifdef _WINDOWS
 #define CLOSE_SOCKET(sock) closesocket(sock)
 #else
@@ -119,7 +132,6 @@ namespace PixiJS
 #define CLOSE_SOCKET(sock) close(sock)
 #endif
 #endif
-#endif
 
 #define DICT_OUTPUT_FILE      "PublishSettings.PixiJS.OutputFile"
 #define DICT_VERSION          "PublishSettings.PixiJS.OutputVersion"
@@ -135,20 +147,36 @@ namespace PixiJS
 
 #define DICT_SPRITESHEETS     "PublishSettings.PixiJS.Spritesheets"
 #define DICT_COMPACT_SHAPES   "PublishSettings.PixiJS.CompactShapes"
+#define DICT_PACK_SHAPES      "PublishSettings.PixiJS.PackShapes"
+#define DICT_SHAPE_GRID       "PublishSettings.PixiJS.ShapeGrid"
+#define DICT_INSTANCE_SHAPES  "PublishSettings.PixiJS.InstanceShapes"
+#define DICT_PATH_PRECISION   "PublishSettings.PixiJS.PathPrecision"
+#define DICT_MATRIX_PRECISION "PublishSettings.PixiJS.MatrixPrecision"
+#define DICT_COLOR_PRECISION  "PublishSettings.PixiJS.ColorPrecision"
+#define DICT_ALPHA_PRECISION  "PublishSettings.PixiJS.AlphaPrecision"
+
+// The JSON writer never prints more decimals than this
+#define MAX_PRECISION         6
 #define DICT_COMPRESS_JS      "PublishSettings.PixiJS.CompressJS"
 #define DICT_HTML             "PublishSettings.PixiJS.HTML"
 #define DICT_LIBS             "PublishSettings.PixiJS.Libs"
 #define DICT_IMAGES           "PublishSettings.PixiJS.Images"
 #define DICT_SOUNDS           "PublishSettings.PixiJS.Sounds"
 #define DICT_LOOP_TIMELINE    "PublishSettings.PixiJS.LoopTimeline"
+#define DICT_STREAM_DATA      "PublishSettings.PixiJS.StreamData"
+#define DICT_COMPILER_SERVER  "PublishSettings.PixiJS.CompilerServer"
+#define DICT_ASSET_CACHE      "PublishSettings.PixiJS.AssetCache"
+#define DICT_BROWSER_PREVIEW  "PublishSettings.PixiJS.BrowserPreview"
+#define DICT_PROFILE_PUBLISH  "PublishSettings.PixiJS.ProfilePublish"
+#define DICT_SIZE_REPORT      "PublishSettings.PixiJS.SizeReport"
+#define DICT_SEEK_INTERVAL    "PublishSettings.PixiJS.SeekInterval"
+#define DICT_TWEEN_MOVES      "PublishSettings.PixiJS.TweenMoves"
 
 /* -------------------------------------------------- Structs / Unions */
 
-#ifdef USE_HTTP_SERVER
 #ifdef _MAC
 typedef int SOCKET;
 #endif
-#endif // USE_HTTP_SERVER
 
 
 /* -------------------------------------------------- Class Decl */
@@ -208,6 +236,18 @@ namespace PixiJS
 			DOM::Utils::POINT2D& inPoint,
 			DOM::Utils::POINT2D& outPoint);
 
+		// Set the number of decimals kept for a category of numbers
+		static void SetPrecision(PrecisionCategory category, int decimals);
+
+		// Round a number to the decimals kept for its category
+		static double Round(double value, PrecisionCategory category);
+
+		// Combine two matrices, the result applies m2 then m1
+		static void ConcatMatrix(
+			const DOM::Utils::MATRIX2D& m1,
+			const DOM::Utils::MATRIX2D& m2,
+			DOM::Utils::MATRIX2D& outMatrix);
+
 		static void GetParent(const std::string& path, std::string& parent);
 
 		static void GetParentByFLA(const std::string& path, std::string& parent);
@@ -228,6 +268,9 @@ namespace PixiJS
 
 		static FCM::Result GetAppTempDir(FCM::PIFCMCallback pCallback, std::string& path);
 
+		// Folder kept between publishes, without a trailing separator
+		static FCM::Result GetCacheDir(FCM::PIFCMCallback pCallback, std::string& path);
+
 		static FCM::AutoPtr<FCM::IFCMCalloc> GetCallocService(FCM::PIFCMCallback pCallback);
 
 		static FCM::AutoPtr<FCM::IFCMStringUtils> GetStringUtilsService(FCM::PIFCMCallback pCallback);
@@ -253,6 +296,13 @@ namespace PixiJS
 			const std::string& dstFolder,
 			FCM::PIFCMCallback pCallback);
 
+		// Update dstFolder to match srcFolder, copying only changed files
+		static FCM::Result SyncDir(
+			const std::string& srcFolder,
+			const std::string& dstFolder,
+			FCM::PIFCMCallback pCallback,
+			FCM::U_Int32& copiedCount);
+
 		static FCM::Result CopyAFile(
 			const std::string& srcFile,
 			const std::string& dstFolder,
@@ -287,19 +337,39 @@ namespace PixiJS
 			const std::string &from,
 			const std::string &to);
 
-		static int RunElectron(std::string argline);
+		// Run electron and wait for it, a timeout of 0 waits as long as it
+		// takes. Its output is traced when it fails and pCallback is set.
+		static int RunElectron(std::string argline, int timeoutMs, FCM::PIFCMCallback pCallback);
+
+		// Start electron with a pipe to its standard input, the process is
+		// ended with CloseElectron. Returns NULL on failure.
+		static Process* OpenElectron(std::string argline);
+
+		// Close the input of electron, wait for it to exit and delete it
+		static int CloseElectron(Process* pProcess, FCM::PIFCMCallback pCallback);
+
+		static FCM::U_Int64 Hash(const std::string& content);
+
+		// A second hash unrelated to Hash, for confirming a match found by it
+		static FCM::U_Int64 CheckHash(const std::string& content);
 
 
 #ifdef USE_HTTP_SERVER
 
 		static void LaunchBrowser(const std::string& outputFile, int port, FCM::PIFCMCallback pCallback);
+#endif
 
 		static int GetUnusedLocalPort();
 
-	private:
-
+		// Set up a loopback address, the port is filled in by the caller
 		static void InitSockAddr(sockaddr_in* sockAddr);
-#endif
+
+		// Load the socket library, where there is one to load
+		static bool StartSockets();
+
+		// Send one request line to a local port and read the reply line,
+		// a timeout of 0 waits as long as it takes
+		static bool SendRequest(int port, const std::string& request, std::string& reply, int timeoutMs);
 
 		static void RemoveTrailingZeroes(char *str);
 
@@ -0,0 +1,247 @@
+//
+//  AssetCache.cpp
+//  PixiAnimate.mp
+//
+//  Remembers the bitmaps exported by earlier publishes of a document, so
+//  files already on disk don't have to be exported again while the saved
+//  document is unchanged.
+//
+
+#include "AssetCache.h"
+#include "libjson.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <sstream>
+#include <iterator>
+
+namespace PixiJS
+{
+	static std::string GetString(const JSONNode& node, const std::string& name)
+	{
+		JSONNode::const_iterator it = node.find(name);
+		return it == node.end() ? "" : it->as_string();
+	}
+
+	AssetCache::AssetCache(FCM::PIFCMCallback pCallback)
+		: m_pCallback(pCallback),
+		m_document(0),
+		m_documentKnown(false),
+		m_dirty(false)
+	{
+	}
+
+	void AssetCache::Load(const std::string& documentKey, const std::string& documentPath)
+	{
+		m_entries.clear();
+		m_dirty = false;
+
+		// The exported files can't show what the library holds now, the
+		// saved document is the only evidence that a bitmap is the same
+		m_documentKnown = HashDocument(documentPath, m_document);
+		if (!m_documentKnown)
+		{
+			return;
+		}
+
+		std::string dir;
+		if (FCM_FAILURE_CODE(Utils::GetCacheDir(m_pCallback, dir)))
+		{
+			return;
+		}
+
+		std::stringstream name;
+		name << std::hex << Utils::Hash(documentKey) << ".json";
+		m_cacheFile = dir + "/" + name.str();
+
+		std::fstream file;
+		Utils::OpenFStream(m_cacheFile, file, std::ios_base::in | std::ios_base::binary, m_pCallback);
+		if (!file.is_open())
+		{
+			// First publish of this document
+			return;
+		}
+
+		std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		file.close();
+
+		// A damaged cache is the same as no cache
+		if (!libjson::is_valid(content))
+		{
+			return;
+		}
+
+		JSONNode root = libjson::parse(content);
+		JSONNode::const_iterator assets = root.find("assets");
+		if (assets == root.end())
+		{
+			return;
+		}
+
+		// Saved since, any bitmap could have changed
+		FCM::U_Int64 document = 0;
+		std::stringstream documentHash(GetString(root, "document"));
+		documentHash >> std::hex >> document;
+		if (document != m_document)
+		{
+			m_dirty = true;
+			return;
+		}
+
+		for (JSONNode::const_iterator it = assets->begin(); it != assets->end(); it++)
+		{
+			Entry entry;
+			entry.signature = GetString(*it, "signature");
+			entry.exportPath = GetString(*it, "path");
+			entry.size = 0;
+			entry.hash = 0;
+
+			std::stringstream hash(GetString(*it, "hash"));
+			hash >> std::hex >> entry.hash;
+
+			std::stringstream size(GetString(*it, "size"));
+			size >> entry.size;
+
+			m_entries[GetString(*it, "item")] = entry;
+		}
+	}
+
+	bool AssetCache::IsCurrent(
+		const std::string& libPathName,
+		const std::string& signature,
+		const std::string& exportPath)
+	{
+		std::map<std::string, Entry>::iterator it = m_entries.find(libPathName);
+		if (!m_documentKnown ||
+			it == m_entries.end() ||
+			it->second.signature != signature ||
+			it->second.exportPath != exportPath)
+		{
+			return false;
+		}
+
+		// The file could have been deleted or overwritten since
+		FCM::U_Int64 hash;
+		FCM::U_Int64 size;
+		return HashFile(exportPath, hash, size) &&
+			size == it->second.size &&
+			hash == it->second.hash;
+	}
+
+	void AssetCache::Update(
+		const std::string& libPathName,
+		const std::string& signature,
+		const std::string& exportPath)
+	{
+		if (!m_documentKnown)
+		{
+			return;
+		}
+
+		Entry entry;
+		entry.signature = signature;
+		entry.exportPath = exportPath;
+
+		if (!HashFile(exportPath, entry.hash, entry.size))
+		{
+			// Nothing was written, don't trust this item next time
+			m_dirty |= m_entries.erase(libPathName) > 0;
+			return;
+		}
+
+		m_entries[libPathName] = entry;
+		m_dirty = true;
+	}
+
+	FCM::Result AssetCache::Save()
+	{
+		if (!m_dirty || m_cacheFile.empty())
+		{
+			return FCM_SUCCESS;
+		}
+
+		JSONNode assets(JSON_ARRAY);
+		assets.set_name("assets");
+
+		for (std::map<std::string, Entry>::iterator it = m_entries.begin(); it != m_entries.end(); it++)
+		{
+			std::stringstream hash;
+			hash << std::hex << it->second.hash;
+
+			std::stringstream size;
+			size << it->second.size;
+
+			JSONNode entry(JSON_NODE);
+			entry.push_back(JSONNode("item", it->first));
+			entry.push_back(JSONNode("signature", it->second.signature));
+			entry.push_back(JSONNode("path", it->second.exportPath));
+			entry.push_back(JSONNode("hash", hash.str()));
+			entry.push_back(JSONNode("size", size.str()));
+			assets.push_back(entry);
+		}
+
+		std::stringstream document;
+		document << std::hex << m_document;
+
+		JSONNode root(JSON_NODE);
+		root.push_back(JSONNode("document", document.str()));
+		root.push_back(assets);
+
+		std::fstream file;
+		Utils::OpenFStream(m_cacheFile, file,
+			std::ios_base::trunc | std::ios_base::out | std::ios_base::binary,
+			m_pCallback);
+		if (!file.is_open())
+		{
+			return FCM_GENERAL_ERROR;
+		}
+
+		file << root.write();
+		file.close();
+		m_dirty = false;
+
+		return FCM_SUCCESS;
+	}
+
+	bool AssetCache::HashFile(const std::string& path, FCM::U_Int64& hash, FCM::U_Int64& size) const
+	{
+		std::fstream file;
+		Utils::OpenFStream(path, file, std::ios_base::in | std::ios_base::binary, m_pCallback);
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		file.close();
+
+		hash = Utils::Hash(content);
+		size = content.size();
+		return true;
+	}
+
+	bool AssetCache::HashDocument(const std::string& documentPath, FCM::U_Int64& hash) const
+	{
+		if (documentPath.empty())
+		{
+			return false;
+		}
+
+		std::string ext;
+		Utils::GetFileExtension(documentPath, ext);
+		std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+		// An XFL folder is rewritten on save through its DOMDocument.xml,
+		// which also records every change to a bitmap item
+		std::string path(documentPath);
+		if (ext == "xfl")
+		{
+			std::string folder;
+			Utils::GetParent(documentPath, folder);
+			path = folder + "DOMDocument.xml";
+		}
+
+		FCM::U_Int64 size;
+		return HashFile(path, hash, size);
+	}
+};
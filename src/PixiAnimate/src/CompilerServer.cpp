@@ -0,0 +1,142 @@
+//
+//  CompilerServer.cpp
+//  PixiAnimate.mp
+//
+//  Keeps one compiler process running for the whole session and sends
+//  it each publish over a local port, so Electron only starts once.
+//
+
+#include "CompilerServer.h"
+#include "Process.h"
+#include "libjson.h"
+#include "Utils.h"
+
+#include <chrono>
+#include <thread>
+
+// Time to wait for a cold start of the compiler
+#define SERVER_START_TIMEOUT 30000
+
+// Time for a running compiler to answer a ping
+#define SERVER_PING_TIMEOUT 1000
+
+// Time for the compiler to quit once its input is closed
+#define SERVER_STOP_TIMEOUT 5000
+
+namespace PixiJS
+{
+	CompilerServer& CompilerServer::GetInstance()
+	{
+		static CompilerServer server;
+		return server;
+	}
+
+	CompilerServer::CompilerServer()
+		: m_port(-1),
+		m_pProcess(NULL)
+	{
+	}
+
+	CompilerServer::~CompilerServer()
+	{
+		Stop();
+	}
+
+	FCM::Result CompilerServer::Compile(
+		const std::string& compiler,
+		const std::string& dataFile,
+		bool debug,
+		FCM::PIFCMCallback pCallback)
+	{
+		if (!Utils::StartSockets())
+		{
+			return FCM_GENERAL_ERROR;
+		}
+
+		// Health check, replace a compiler that died or hung
+		if (m_pProcess == NULL || compiler != m_compiler || !Ping())
+		{
+			Stop();
+
+			FCM::Result res = Start(compiler, pCallback);
+			if (FCM_FAILURE_CODE(res))
+			{
+				return res;
+			}
+		}
+
+		JSONNode request(JSON_NODE);
+		request.push_back(JSONNode("src", dataFile));
+		request.push_back(JSONNode("debug", debug));
+
+		std::string reply;
+		if (!Utils::SendRequest(m_port, request.write(), reply, 0))
+		{
+			// Start a new one next time
+			Stop();
+			return FCM_GENERAL_ERROR;
+		}
+
+		// Anything else is "error" and the message
+		if (reply != "ok")
+		{
+			std::string message = reply.substr(reply.find(' ') + 1);
+			Utils::Trace(pCallback, "ERROR: %s\n", message.c_str());
+		}
+
+		return FCM_SUCCESS;
+	}
+
+	void CompilerServer::Stop()
+	{
+		if (m_pProcess != NULL)
+		{
+			// A hung compiler is ended with what it started
+			int exitCode;
+			m_pProcess->CloseInput();
+			if (!m_pProcess->Wait(SERVER_STOP_TIMEOUT, exitCode))
+			{
+				m_pProcess->Kill();
+			}
+			delete m_pProcess;
+			m_pProcess = NULL;
+		}
+	}
+
+	FCM::Result CompilerServer::Start(const std::string& compiler, FCM::PIFCMCallback pCallback)
+	{
+		m_port = Utils::GetUnusedLocalPort();
+		if (m_port < 0)
+		{
+			return FCM_GENERAL_ERROR;
+		}
+
+		std::string args = "\"" + compiler + "\" --server --port " + Utils::ToString((FCM::S_Int32)m_port);
+		m_pProcess = Utils::OpenElectron(args);
+		if (m_pProcess == NULL)
+		{
+			return FCM_GENERAL_ERROR;
+		}
+		m_compiler = compiler;
+
+		for (int waited = 0; waited < SERVER_START_TIMEOUT; waited += 100)
+		{
+			if (Ping())
+			{
+				return FCM_SUCCESS;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		}
+
+		Utils::Trace(pCallback, "Compiler server did not start, running the compiler directly\n");
+		Stop();
+
+		return FCM_GENERAL_ERROR;
+	}
+
+	bool CompilerServer::Ping()
+	{
+		std::string reply;
+		return Utils::SendRequest(m_port, "ping", reply, SERVER_PING_TIMEOUT) && reply == "pong";
+	}
+};
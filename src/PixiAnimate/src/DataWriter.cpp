@@ -0,0 +1,418 @@
+//
+//  DataWriter.cpp
+//  PixiAnimate.mp
+//
+//  Streams the publish data document to disk one asset at a time so
+//  that the size of the document never has to fit in memory.
+//
+
+#include "DataWriter.h"
+#include "Profiler.h"
+#include "SizeReport.h"
+#include "libjson.h"
+#include "Utils.h"
+
+#include <cstdio>
+
+namespace PixiJS
+{
+	// Names of the top-level arrays, must match DataWriter::Section
+	static const char* sectionNames[DataWriter::SECTION_COUNT] =
+	{
+		"Shapes",
+		"Bitmaps",
+		"Sounds",
+		"Texts",
+		"Timelines",
+		"Tweens",
+		"FillStyles",
+		"StrokeStyles",
+		"Gradients"
+	};
+
+	DataWriter::DataWriter(const std::string& outputFile, FCM::PIFCMCallback pCallback)
+		: m_outputFile(outputFile),
+		m_pCallback(pCallback),
+		m_open(false),
+		m_pStream(NULL),
+		m_pSizeReport(NULL),
+		m_stopping(false)
+	{
+		for (int i = 0; i < SECTION_COUNT; i++)
+		{
+			m_sectionEmpty[i] = true;
+		}
+	}
+
+	DataWriter::~DataWriter()
+	{
+		// Publish didn't get to EndDocument, don't leave temp files behind
+		if (m_open)
+		{
+			Discard();
+		}
+	}
+
+	void DataWriter::SetStream(FILE* pStream)
+	{
+		ASSERT(!m_open);
+
+		m_pStream = pStream;
+	}
+
+	void DataWriter::SetSizeReport(SizeReport* pSizeReport)
+	{
+		m_pSizeReport = pSizeReport;
+	}
+
+	FCM::Result DataWriter::Open()
+	{
+		for (int i = 0; i < SECTION_COUNT; i++)
+		{
+			std::string sectionFile = GetSectionFile((Section)i);
+			Utils::OpenFStream(sectionFile, m_sections[i],
+				std::ios_base::trunc | std::ios_base::in | std::ios_base::out | std::ios_base::binary,
+				m_pCallback);
+
+			if (!m_sections[i].is_open())
+			{
+				Utils::Trace(m_pCallback, "ERROR: Data file (%s) could not be created\n", sectionFile.c_str());
+				Discard();
+				return FCM_GENERAL_ERROR;
+			}
+			m_sectionEmpty[i] = true;
+		}
+		m_open = true;
+
+		if (m_pStream != NULL)
+		{
+			fprintf(m_pStream, "{\"%s\":[", sectionNames[0]);
+		}
+
+		StartWorkers();
+
+		return FCM_SUCCESS;
+	}
+
+	static std::string Serialize(const JSONNode& node)
+	{
+#ifdef _DEBUG
+		return node.write_formatted();
+#else
+		return node.write();
+#endif
+	}
+
+	void DataWriter::Write(Section section, const JSONNode& node, FCM::U_Int32 assetId)
+	{
+		Write(section, Serialize(node), assetId);
+	}
+
+	void DataWriter::Write(Section section, const std::string& json, FCM::U_Int32 assetId)
+	{
+		ASSERT(m_open);
+
+		if (m_pSizeReport != NULL)
+		{
+			m_pSizeReport->AddBytes(section, assetId, json.size());
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (m_jobs.empty())
+		{
+			Append(section, json);
+			return;
+		}
+
+		// Queue behind the pending jobs so the order is kept
+		Job* pJob = new Job();
+		ASSERT(pJob);
+
+		pJob->section = section;
+		pJob->pNode = NULL;
+		pJob->assetId = assetId;
+		pJob->json = json;
+		pJob->taken = true;
+		pJob->done = true;
+		m_jobs.push_back(pJob);
+	}
+
+	void DataWriter::WriteAsync(Section section, JSONNode* pNode, FCM::U_Int32 assetId)
+	{
+		ASSERT(m_open);
+
+		if (m_workers.empty())
+		{
+			FCM::U_Int64 start = SizeReport::Now();
+			std::string json = Serialize(*pNode);
+			delete pNode;
+
+			if (m_pSizeReport != NULL)
+			{
+				m_pSizeReport->AddTime(section, assetId, SizeReport::Now() - start);
+			}
+
+			Write(section, json, assetId);
+			return;
+		}
+
+		Job* pJob = new Job();
+		ASSERT(pJob);
+
+		pJob->section = section;
+		pJob->pNode = pNode;
+		pJob->assetId = assetId;
+		pJob->taken = false;
+		pJob->done = false;
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_jobs.push_back(pJob);
+		m_jobQueued.notify_one();
+	}
+
+	void DataWriter::Append(Section section, const std::string& json)
+	{
+		if (m_pStream != NULL && section == 0)
+		{
+			if (!m_sectionEmpty[section])
+			{
+				fputc(',', m_pStream);
+			}
+			fwrite(json.data(), 1, json.size(), m_pStream);
+			m_sectionEmpty[section] = false;
+			return;
+		}
+
+		std::fstream& file = m_sections[section];
+		if (!m_sectionEmpty[section])
+		{
+			file << ",";
+		}
+		file << json;
+		m_sectionEmpty[section] = false;
+	}
+
+	void DataWriter::Flush()
+	{
+		while (!m_jobs.empty() && m_jobs.front()->done)
+		{
+			Job* pJob = m_jobs.front();
+			m_jobs.pop_front();
+
+			Append(pJob->section, pJob->json);
+			delete pJob;
+		}
+
+		if (m_jobs.empty())
+		{
+			m_jobsDone.notify_all();
+		}
+	}
+
+	void DataWriter::Worker()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		while (true)
+		{
+			Job* pJob = NULL;
+			for (std::deque<Job*>::iterator it = m_jobs.begin(); it != m_jobs.end(); it++)
+			{
+				if (!(*it)->taken)
+				{
+					pJob = *it;
+					break;
+				}
+			}
+
+			if (pJob == NULL)
+			{
+				if (m_stopping)
+				{
+					return;
+				}
+				m_jobQueued.wait(lock);
+				continue;
+			}
+
+			pJob->taken = true;
+			lock.unlock();
+
+			// The node is owned by this job alone, nothing else touches it
+			std::string json;
+			FCM::U_Int64 start = SizeReport::Now();
+			{
+				ProfileScope scope("Serialize");
+				json = Serialize(*pJob->pNode);
+			}
+			delete pJob->pNode;
+
+			if (m_pSizeReport != NULL)
+			{
+				m_pSizeReport->AddTime(pJob->section, pJob->assetId, SizeReport::Now() - start);
+				m_pSizeReport->AddBytes(pJob->section, pJob->assetId, json.size());
+			}
+
+			lock.lock();
+			pJob->pNode = NULL;
+			pJob->json.swap(json);
+			pJob->done = true;
+			Flush();
+		}
+	}
+
+	void DataWriter::StartWorkers()
+	{
+		// Keep a core for the main thread, which is still walking the document
+		unsigned int count = std::thread::hardware_concurrency();
+		if (count > 1)
+		{
+			count--;
+		}
+		else
+		{
+			// Single core or unknown, serialize on the calling thread
+			count = 0;
+		}
+
+		m_stopping = false;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			m_workers.push_back(std::thread(&DataWriter::Worker, this));
+		}
+	}
+
+	void DataWriter::StopWorkers()
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_stopping = true;
+			m_jobQueued.notify_all();
+		}
+
+		for (size_t i = 0; i < m_workers.size(); i++)
+		{
+			m_workers[i].join();
+		}
+		m_workers.clear();
+	}
+
+	FCM::Result DataWriter::Close(const JSONNode& meta)
+	{
+		ASSERT(m_open);
+
+		// Let the workers finish the queued entries before joining the sections
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while (!m_jobs.empty())
+			{
+				m_jobsDone.wait(lock);
+			}
+		}
+		StopWorkers();
+
+		if (m_pStream != NULL)
+		{
+			return CloseStream(meta);
+		}
+
+		std::fstream output;
+		Utils::OpenFStream(m_outputFile, output,
+			std::ios_base::trunc | std::ios_base::out | std::ios_base::binary,
+			m_pCallback);
+
+		if (!output.is_open())
+		{
+			Utils::Trace(m_pCallback, "ERROR: Data file (%s) could not be written\n", m_outputFile.c_str());
+			Discard();
+			return FCM_GENERAL_ERROR;
+		}
+
+		output << "{";
+		for (int i = 0; i < SECTION_COUNT; i++)
+		{
+			output << "\"" << sectionNames[i] << "\":[";
+
+			// Copy the section through the stream buffers, an empty
+			// section would set the failbit on the output
+			if (!m_sectionEmpty[i])
+			{
+				m_sections[i].seekg(0, std::ios_base::beg);
+				output << m_sections[i].rdbuf();
+			}
+			output << "],";
+		}
+		output << "\"_meta\":" << meta.write() << "}";
+		output.close();
+
+		Discard();
+
+		return FCM_SUCCESS;
+	}
+
+	FCM::Result DataWriter::CloseStream(const JSONNode& meta)
+	{
+		char buffer[65536];
+
+		// The first section is already in the stream
+		fputs("],", m_pStream);
+		for (int i = 1; i < SECTION_COUNT; i++)
+		{
+			fprintf(m_pStream, "\"%s\":[", sectionNames[i]);
+
+			if (!m_sectionEmpty[i])
+			{
+				m_sections[i].seekg(0, std::ios_base::beg);
+				while (m_sections[i].read(buffer, sizeof(buffer)) || m_sections[i].gcount() > 0)
+				{
+					fwrite(buffer, 1, (size_t)m_sections[i].gcount(), m_pStream);
+				}
+			}
+			fputs("],", m_pStream);
+		}
+
+		std::string json = meta.write();
+		fprintf(m_pStream, "\"_meta\":%s}", json.c_str());
+		fflush(m_pStream);
+
+		bool failed = ferror(m_pStream) != 0;
+
+		Discard();
+
+		if (failed)
+		{
+			Utils::Trace(m_pCallback, "ERROR: Data could not be sent to the compiler\n");
+			return FCM_GENERAL_ERROR;
+		}
+		return FCM_SUCCESS;
+	}
+
+	void DataWriter::Discard()
+	{
+		StopWorkers();
+
+		// Drop whatever was still queued
+		for (std::deque<Job*>::iterator it = m_jobs.begin(); it != m_jobs.end(); it++)
+		{
+			delete (*it)->pNode;
+			delete *it;
+		}
+		m_jobs.clear();
+
+		for (int i = 0; i < SECTION_COUNT; i++)
+		{
+			if (m_sections[i].is_open())
+			{
+				m_sections[i].close();
+			}
+			std::remove(GetSectionFile((Section)i).c_str());
+		}
+		m_open = false;
+	}
+
+	std::string DataWriter::GetSectionFile(Section section) const
+	{
+		return m_outputFile + "." + sectionNames[section];
+	}
+};
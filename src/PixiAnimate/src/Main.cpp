@@ -21,6 +21,9 @@
 #include "DocType.h"
 #include "Publisher.h"
 #include "Utils.h"
+#include "CompilerServer.h"
+#include "PreviewWindow.h"
+#include "PreviewServer.h"
 
 namespace PixiJS
 {
@@ -108,6 +111,13 @@ private:
 
 	extern "C" FCMPLUGIN_IMP_EXP FCM::Result PluginShutdown()
 	{
+		// Don't leave the compiler or preview running after the plugin goes away
+		CompilerServer::GetInstance().Stop();
+		PreviewWindow::GetInstance().Stop();
+#ifdef USE_HTTP_SERVER
+		PreviewServer::GetInstance().Stop();
+#endif
+
 		g_jiboPixiJSModule.finalize();
 
 		return FCM_SUCCESS;
@@ -56,6 +56,11 @@
 #include "Utils/ILinearColorGradient.h"
 #include <math.h>
 #include "TimelineWriter.h"
+#include "CompilerServer.h"
+#include "Process.h"
+#include "PreviewWindow.h"
+#include "PreviewServer.h"
+#include "Profiler.h"
 
 #ifdef _WINDOWS
 #include <experimental\filesystem>
@@ -117,7 +122,23 @@ namespace PixiJS
 		m_stageHeight = stageHeight;
 		m_background = sstream.str();
 
-		return FCM_SUCCESS;
+		// Start the compiler now so it loads while the document is walked,
+		// a compiler server is already loaded and reads the data file
+		if (m_streamData && !m_compilerServer)
+		{
+			m_pCompiler = Utils::OpenElectron(GetCompilerArgs() + " --stdin");
+			if (m_pCompiler == NULL)
+			{
+				Utils::Trace(m_pCallback, "Compiler could not be started, writing the data file instead\n");
+			}
+			else
+			{
+				m_pDataWriter->SetStream(m_pCompiler->GetInput());
+			}
+		}
+
+		// Assets are streamed to the data file as they are defined
+		return m_pDataWriter->Open();
 	}
 
 	void OutputWriter::AddTweens(JSONNode* tweens)
@@ -127,14 +148,12 @@ namespace PixiJS
 
 	FCM::Result OutputWriter::EndDocument()
 	{
-		m_pRootNode->push_back(*m_pShapeArray);
-		m_pRootNode->push_back(*m_pBitmapArray);
-		m_pRootNode->push_back(*m_pSoundArray);
-		m_pRootNode->push_back(*m_pTextArray);
-		m_pRootNode->push_back(*m_pTimelineArray);
 		if (m_pTweenArray != NULL)
 		{
-			m_pRootNode->push_back(*m_pTweenArray);
+			for (JSONNode::const_iterator i = m_pTweenArray->begin(); i != m_pTweenArray->end(); i++)
+			{
+				m_pDataWriter->Write(DataWriter::TWEENS, *i);
+			}
 		}
 
 		JSONNode meta(JSON_NODE);
@@ -145,6 +164,10 @@ namespace PixiJS
 		meta.push_back(JSONNode("stageName", m_stageName));
 		meta.push_back(JSONNode("compressJS", m_compressJS));
 		meta.push_back(JSONNode("compactShapes", m_compactShapes));
+		if (m_shapeGrid > 0)
+		{
+			meta.push_back(JSONNode("shapeGrid", m_shapeGrid));
+		}
 		meta.push_back(JSONNode("nameSpace", m_nameSpace));
 		meta.push_back(JSONNode("loopTimeline", m_loopTimeline));
 		meta.push_back(JSONNode("framerate", m_framerate));
@@ -175,30 +198,82 @@ namespace PixiJS
 		std::string patch = Utils::ToString(PIXIJS_PLUGIN_VERSION_MAINTENANCE);
 
 		meta.push_back(JSONNode("version", (major)+"." + (minor)+"." + (patch)));
-		m_pRootNode->push_back(meta);
 
-		// Write the JSON file (overwrite file if it already exists)
-#ifdef _DEBUG
-	// If we're in DEBUG mode, write the well-formated JSON with whitespace
-		Save(m_outputDataFile, m_pRootNode->write_formatted());
-#else
-	// JSON with no whitespace
-		Save(m_outputDataFile, m_pRootNode->write());
-#endif
+		if (m_dedupShapeCount > 0)
+		{
+			Utils::Trace(m_pCallback, "Aliased %d duplicate shapes, saved %llu bytes\n",
+				m_dedupShapeCount, (unsigned long long)m_dedupShapeBytes);
+		}
 
-		std::string extensionPath;
-		Utils::GetExtensionPath(extensionPath, m_pCallback);
-		std::string compiler = extensionPath + NODE_COMPILER;
-		std::string publish = "\"" + compiler + "\" --src \"" + m_outputDataFile + "\"";
+		if (m_bitmapExportsAvoided > 0)
+		{
+			Utils::Trace(m_pCallback, "Skipped %d repeated bitmap exports\n", m_bitmapExportsAvoided);
+		}
+
+		if (m_deadCommandCount > 0)
+		{
+			Utils::Trace(m_pCallback, "Removed %d frame commands with no effect\n", m_deadCommandCount);
+		}
+
+		if (m_pAssetCache)
+		{
+			// Nothing shows whether an unsaved change touched these
+			if (m_cachedBitmapCount > 0)
+			{
+				Utils::Trace(m_pCallback, "WARNING: Reused %d bitmaps exported by an earlier publish of the saved document, "
+					"unsaved changes to them are not published. Clear the publish cache to export them again.\n",
+					m_cachedBitmapCount);
+			}
+			m_pAssetCache->Save();
+		}
 
+		// Finish the JSON file (overwrite file if it already exists)
+		FCM::Result res;
+		{
+			ProfileScope scope("Write data file");
+			res = m_pDataWriter->Close(meta);
+		}
+
+		if (m_pSizeReport && FCM_SUCCESS_CODE(res))
+		{
+			std::string outputName;
+			Utils::GetFileNameWithoutExtension(m_outputFile, outputName);
+			m_pSizeReport->Save(m_basePath + outputName + ".report");
+		}
+
+		{
+			ProfileScope scope("Compile");
+			if (m_pCompiler != NULL)
+			{
+				// End of input, the compiler is already running
+				Utils::CloseElectron(m_pCompiler, m_pCallback);
+				m_pCompiler = NULL;
+			}
+			else if (FCM_SUCCESS_CODE(res))
+			{
 #ifdef _DEBUG
-		publish += " --debug";
+				bool debug = true;
+#else
+				bool debug = false;
 #endif
-		Utils::RunElectron(publish);
+				// Run the compiler ourselves if the server can't be reached
+				if (!m_compilerServer || FCM_FAILURE_CODE(CompilerServer::GetInstance().Compile(
+					GetCompilerPath(), m_outputDataFile, debug, m_pCallback)))
+				{
+					Utils::RunElectron(GetCompilerArgs(), 0, m_pCallback);
+				}
+			}
+		}
+
+		if (FCM_FAILURE_CODE(res))
+		{
+			return res;
+		}
 
 		// Output the HTML templates
 		if (m_html)
 		{
+			ProfileScope scope("Save HTML");
 			if (m_outputVersion == "1.0")
 			{
 				if (m_compressJS)
@@ -256,9 +331,27 @@ namespace PixiJS
 			}
 		}
 
+		ProfileScope scope("Write timeline", timelineName);
+		FCM::U_Int64 start = SizeReport::Now();
+
+		pWriter->SetSeekInterval(m_seekInterval);
+		pWriter->SetTweenMoves(m_tweenMoves);
 		pWriter->Finish(resId, pName, timelineName);
+		m_deadCommandCount += pWriter->GetDeadCommandCount();
+
+		if (m_pSizeReport)
+		{
+			m_pSizeReport->SetName(DataWriter::TIMELINES, resId, timelineName);
+			m_pSizeReport->AddCommands(resId, *pWriter->GetRoot());
+		}
+
+		// Serialize on the worker pool, the timeline writer's nodes share
+		// refcounted internals so the worker gets its own deep copy
+		JSONNode* pTimeline = new JSONNode(pWriter->GetRoot()->duplicate());
+		ASSERT(pTimeline);
 
-		m_pTimelineArray->push_back(*(pWriter->GetRoot()));
+		m_pDataWriter->WriteAsync(DataWriter::TIMELINES, pTimeline, resId);
+		AddDefineTime(DataWriter::TIMELINES, resId, start);
 
 		return FCM_SUCCESS;
 	}
@@ -272,6 +365,9 @@ namespace PixiJS
 		ASSERT(m_pathArray);
 		m_pathArray->set_name("paths");
 
+		m_defineStart = SizeReport::Now();
+		m_pathSegmentCount = 0;
+
 		return FCM_SUCCESS;
 	}
 
@@ -279,10 +375,51 @@ namespace PixiJS
 	// Marks the end of a shape
 	FCM::Result OutputWriter::EndDefineShape(FCM::U_Int32 resId)
 	{
-		m_shapeElem->push_back(JSONNode("assetId", resId));
-		m_shapeElem->push_back(*m_pathArray);
+		// The paths hold all of the geometry and styles of the shape,
+		// shapes that write the same paths are exported once
+		std::string paths = m_pathArray->write();
+		FCM::U_Int64 hash = Utils::Hash(paths);
+
+		// Only a shape with the same length and second hash is a duplicate,
+		// the paths themselves are not kept
+		SHAPE_DIGEST digest;
+		digest.resId = resId;
+		digest.size = paths.size();
+		digest.check = Utils::CheckHash(paths);
+
+		std::multimap<FCM::U_Int64, SHAPE_DIGEST>::iterator it = m_shapeMap.lower_bound(hash);
+		for (; it != m_shapeMap.end() && it->first == hash; it++)
+		{
+			if (it->second.size == digest.size && it->second.check == digest.check)
+			{
+				break;
+			}
+		}
 
-		m_pShapeArray->push_back(*m_shapeElem);
+		if (it != m_shapeMap.end() && it->first == hash)
+		{
+			m_shapeElem->push_back(JSONNode("assetId", resId));
+			m_shapeElem->push_back(JSONNode("alias", it->second.resId));
+
+			m_pDataWriter->Write(DataWriter::SHAPES, *m_shapeElem, resId);
+
+			m_dedupShapeCount++;
+			m_dedupShapeBytes += paths.size();
+		}
+		else
+		{
+			m_shapeMap.insert(std::pair<FCM::U_Int64, SHAPE_DIGEST>(hash, digest));
+
+			m_pDataWriter->Write(DataWriter::SHAPES,
+				"{\"assetId\":" + Utils::ToString(resId) + ",\"paths\":" + paths + "}", resId);
+
+			if (m_pSizeReport)
+			{
+				m_pSizeReport->AddPathSegments(resId, m_pathSegmentCount);
+			}
+		}
+
+		AddDefineTime(DataWriter::SHAPES, resId, m_defineStart);
 
 		delete m_pathArray;
 		delete m_shapeElem;
@@ -297,9 +434,7 @@ namespace PixiJS
 		m_pathElem = new JSONNode(JSON_NODE);
 		ASSERT(m_pathElem);
 
-		m_pathCmdArray = new JSONNode(JSON_ARRAY);
-		ASSERT(m_pathCmdArray);
-		m_pathCmdArray->set_name("d");
+		StartPathCommands();
 
 		return FCM_SUCCESS;
 	}
@@ -308,9 +443,12 @@ namespace PixiJS
 	// Solid fill style definition
 	FCM::Result OutputWriter::DefineSolidFillStyle(const DOM::Utils::COLOR& color)
 	{
+		JSONNode fillStyle(JSON_NODE);
 		std::string colorStr = Utils::ToString(color);
-		m_pathElem->push_back(JSONNode("color", colorStr.c_str()));
-		m_pathElem->push_back(JSONNode("alpha", (float)(color.alpha / 255.0)));
+		fillStyle.push_back(JSONNode("color", colorStr.c_str()));
+		fillStyle.push_back(JSONNode("alpha", Utils::Round(color.alpha / 255.0, ALPHA_PRECISION)));
+
+		SetFillStyle(fillStyle);
 
 		return FCM_SUCCESS;
 	}
@@ -327,7 +465,7 @@ namespace PixiJS
 	{
 		FCM::Result res;
 		std::string name;
-		std::string ext;
+		std::string fileName;
 		JSONNode bitmapElem(JSON_NODE);
 
 		bitmapElem.set_name("image");
@@ -335,55 +473,13 @@ namespace PixiJS
 		bitmapElem.push_back(JSONNode("height", height));
 		bitmapElem.push_back(JSONNode("width", width));
 
-		FCM::AutoPtr<FCM::IFCMUnknown> pUnk;
-
-		FCM::Boolean alreadyExported = GetImageExportFileName(libPathName, name);
-		if (!alreadyExported)
+		res = ExportBitmap(libPathName, pMediaItem, width, height, name, fileName);
+		if (FCM_FAILURE_CODE(res))
 		{
-			if (m_images && !m_imageFolderCreated)
-			{
-				res = Utils::CreateDir(m_outputImageFolder, m_pCallback);
-				if (!(FCM_SUCCESS_CODE(res)))
-				{
-					Utils::Trace(m_pCallback, "Output image folder (%s) could not be created\n", m_outputImageFolder.c_str());
-					return res;
-				}
-				m_imageFolderCreated = true;
-			}
-			Utils::GetFileExtension(libPathName, ext);
-			Utils::GetFileNameWithoutExtension(libPathName, name);
-			SetImageExportFileName(libPathName, name);
-
-			if (ext == "")
-			{
-				ext = "png";
-			}
+			return res;
 		}
 
-		std::string bitmapExportPath(m_outputImageFolder + name + "." + ext);
-		std::string bitmapRelPath(m_imagesPath + name + "." + ext);
-
-		res = m_pCallback->GetService(DOM::FLA_BITMAP_SERVICE, pUnk.m_Ptr);
-		ASSERT(FCM_SUCCESS_CODE(res));
-
-		FCM::AutoPtr<DOM::Service::Image::IBitmapExportService> bitmapExportService = pUnk;
-		if (m_images && bitmapExportService)
-		{
-			FCM::AutoPtr<FCM::IFCMCalloc> pCalloc;
-#ifdef _WINDOWS
-			fs::path exportPath(bitmapExportPath);
-			FCM::StringRep16 pFilePath = Utils::ToString16(fs::canonical(exportPath).string(), m_pCallback);
-#else
-			FCM::StringRep16 pFilePath = Utils::ToString16(bitmapExportPath, m_pCallback);
-#endif
-			res = bitmapExportService->ExportToFile(pMediaItem, pFilePath, 100);
-			ASSERT(FCM_SUCCESS_CODE(res));
-
-			pCalloc = Utils::GetCallocService(m_pCallback);
-			ASSERT(pCalloc.m_Ptr != NULL);
-
-			pCalloc->Free(pFilePath);
-		}
+		std::string bitmapRelPath(m_imagesPath + fileName);
 
 		bitmapElem.push_back(JSONNode("src", bitmapRelPath));
 		bitmapElem.push_back(JSONNode("name", name));
@@ -397,7 +493,10 @@ namespace PixiJS
 		bitmapElem.push_back(JSONNode("patternUnits", "userSpaceOnUse"));
 		bitmapElem.push_back(Utils::ToJSON("patternTransform", matrix1));
 
-		m_pathElem->push_back(bitmapElem);
+		JSONNode fillStyle(JSON_NODE);
+		fillStyle.push_back(bitmapElem);
+
+		SetFillStyle(fillStyle);
 
 		return FCM_SUCCESS;
 	}
@@ -449,7 +548,7 @@ namespace PixiJS
 
 		stopEntry.push_back(JSONNode("offset", offset));
 		stopEntry.push_back(JSONNode("stopColor", Utils::ToString(colorPoint.color)));
-		stopEntry.push_back(JSONNode("stopOpacity", (float)(colorPoint.color.alpha / 255.0)));
+		stopEntry.push_back(JSONNode("stopOpacity", Utils::Round(colorPoint.color.alpha / 255.0, ALPHA_PRECISION)));
 
 		m_stopPointArray->push_back(stopEntry);
 
@@ -460,8 +559,14 @@ namespace PixiJS
 	// End Linear Gradient fill style definition
 	FCM::Result OutputWriter::EndDefineLinearGradientFillStyle()
 	{
+		JSONNode gradient(JSON_NODE);
+		JSONNode fillStyle(JSON_NODE);
+
 		m_gradientColor->push_back(*m_stopPointArray);
-		m_pathElem->push_back(*m_gradientColor);
+		gradient.push_back(*m_gradientColor);
+
+		fillStyle.push_back(JSONNode("gradient", AddStyle(DataWriter::GRADIENTS, m_gradients, gradient)));
+		SetFillStyle(fillStyle);
 
 		delete m_stopPointArray;
 		delete m_gradientColor;
@@ -530,8 +635,14 @@ namespace PixiJS
 	// End Radial Gradient fill style definition
 	FCM::Result OutputWriter::EndDefineRadialGradientFillStyle()
 	{
+		JSONNode gradient(JSON_NODE);
+		JSONNode fillStyle(JSON_NODE);
+
 		m_gradientColor->push_back(*m_stopPointArray);
-		m_pathElem->push_back(*m_gradientColor);
+		gradient.push_back(*m_gradientColor);
+
+		fillStyle.push_back(JSONNode("gradient", AddStyle(DataWriter::GRADIENTS, m_gradients, gradient)));
+		SetFillStyle(fillStyle);
 
 		delete m_stopPointArray;
 		delete m_gradientColor;
@@ -542,14 +653,14 @@ namespace PixiJS
 	FCM::Result OutputWriter::StartDefinePath()
 	{
 		// m_pathCmdArray->push_back(JSONNode("", "startPath"));
-		m_pathCmdArray->push_back(JSONNode("", moveTo));
+		AddPathCommand(PathEncoder::MOVE_TO, moveTo);
 		m_firstSegment = true;
 		return FCM_SUCCESS;
 	}
 
 	FCM::Result OutputWriter::EndDefinePath()
 	{
-		m_pathCmdArray->push_back(JSONNode("", closePath));
+		AddPathCommand(PathEncoder::CLOSE_PATH, closePath);
 		// m_pathCmdArray->push_back(JSONNode("", "endPath"));
 		return FCM_SUCCESS;
 	}
@@ -570,14 +681,14 @@ namespace PixiJS
 	// Start of fill region hole
 	FCM::Result OutputWriter::StartDefineHole()
 	{
-		m_pathCmdArray->push_back(JSONNode("", beginHole));
+		AddPathCommand(PathEncoder::BEGIN_HOLE, beginHole);
 		return StartDefinePath();
 	}
 
 	// End of fill region hole
 	FCM::Result OutputWriter::EndDefineHole()
 	{
-		m_pathCmdArray->push_back(JSONNode("", endHole));
+		AddPathCommand(PathEncoder::END_HOLE, endHole);
 		return FCM_SUCCESS;
 	}
 
@@ -589,30 +700,25 @@ namespace PixiJS
 		{
 			if (segment.segmentType == DOM::Utils::LINE_SEGMENT)
 			{
-				m_pathCmdArray->push_back(JSONNode("", (double)(segment.line.endPoint1.x)));
-				m_pathCmdArray->push_back(JSONNode("", (double)(segment.line.endPoint1.y)));
+				AddPathPoint(segment.line.endPoint1);
 			}
 			else
 			{
-				m_pathCmdArray->push_back(JSONNode("", (double)(segment.quadBezierCurve.anchor1.x)));
-				m_pathCmdArray->push_back(JSONNode("", (double)(segment.quadBezierCurve.anchor1.y)));
+				AddPathPoint(segment.quadBezierCurve.anchor1);
 			}
 			m_firstSegment = false;
 		}
 
 		if (segment.segmentType == DOM::Utils::LINE_SEGMENT)
 		{
-			m_pathCmdArray->push_back(JSONNode("", lineTo));
-			m_pathCmdArray->push_back(JSONNode("", (double)(segment.line.endPoint2.x)));
-			m_pathCmdArray->push_back(JSONNode("", (double)(segment.line.endPoint2.y)));
+			AddPathCommand(PathEncoder::LINE_TO, lineTo);
+			AddPathPoint(segment.line.endPoint2);
 		}
 		else
 		{
-			m_pathCmdArray->push_back(JSONNode("", quadraticCurveTo));
-			m_pathCmdArray->push_back(JSONNode("", (double)(segment.quadBezierCurve.control.x)));
-			m_pathCmdArray->push_back(JSONNode("", (double)(segment.quadBezierCurve.control.y)));
-			m_pathCmdArray->push_back(JSONNode("", (double)(segment.quadBezierCurve.anchor2.x)));
-			m_pathCmdArray->push_back(JSONNode("", (double)(segment.quadBezierCurve.anchor2.y)));
+			AddPathCommand(PathEncoder::QUADRATIC_CURVE_TO, quadraticCurveTo);
+			AddPathPoint(segment.quadBezierCurve.control);
+			AddPathPoint(segment.quadBezierCurve.anchor2);
 		}
 
 		return FCM_SUCCESS;
@@ -658,9 +764,7 @@ namespace PixiJS
 		m_pathElem = new JSONNode(JSON_NODE);
 		ASSERT(m_pathElem);
 
-		m_pathCmdArray = new JSONNode(JSON_ARRAY);
-		ASSERT(m_pathCmdArray);
-		m_pathCmdArray->set_name("d");
+		StartPathCommands();
 
 		return StartDefinePath();
 	}
@@ -669,31 +773,32 @@ namespace PixiJS
 	// End of a stroke
 	FCM::Result OutputWriter::EndDefineStroke()
 	{
-		m_pathElem->push_back(*m_pathCmdArray);
+		EndPathCommands();
 
 		if (m_strokeStyle.type == SOLID_STROKE_STYLE_TYPE)
 		{
-			m_pathElem->push_back(JSONNode("thickness",
+			JSONNode strokeStyle(JSON_NODE);
+
+			strokeStyle.push_back(JSONNode("thickness",
 				(double)m_strokeStyle.solidStrokeStyle.thickness));
-			m_pathElem->push_back(JSONNode("linecap",
+			strokeStyle.push_back(JSONNode("linecap",
 				Utils::ToString(m_strokeStyle.solidStrokeStyle.capStyle.type).c_str()));
-			m_pathElem->push_back(JSONNode("linejoin",
+			strokeStyle.push_back(JSONNode("linejoin",
 				Utils::ToString(m_strokeStyle.solidStrokeStyle.joinStyle.type).c_str()));
 
 			if (m_strokeStyle.solidStrokeStyle.joinStyle.type == DOM::Utils::MITER_JOIN)
 			{
-				m_pathElem->push_back(JSONNode("miterLimit",
+				strokeStyle.push_back(JSONNode("miterLimit",
 					(double)m_strokeStyle.solidStrokeStyle.joinStyle.miterJoinProp.miterLimit));
 			}
+			m_pathElem->push_back(JSONNode("strokeStyle",
+				AddStyle(DataWriter::STROKE_STYLES, m_strokeStyles, strokeStyle)));
 			m_pathElem->push_back(JSONNode("stroke", true));
 		}
 		m_pathArray->push_back(*m_pathElem);
 
 		delete m_pathElem;
-		delete m_pathCmdArray;
-
 		m_pathElem = NULL;
-		m_pathCmdArray = NULL;
 
 		return FCM_SUCCESS;
 	}
@@ -712,16 +817,13 @@ namespace PixiJS
 	{
 		EndDefinePath();
 
-		m_pathElem->push_back(*m_pathCmdArray);
+		EndPathCommands();
 		m_pathElem->push_back(JSONNode("stroke", false));
 
 		m_pathArray->push_back(*m_pathElem);
 
 		delete m_pathElem;
-		delete m_pathCmdArray;
-
 		m_pathElem = NULL;
-		m_pathCmdArray = NULL;
 
 		return FCM_SUCCESS;
 	}
@@ -738,7 +840,8 @@ namespace PixiJS
 		FCM::Result res;
 		JSONNode bitmapElem(JSON_NODE);
 		std::string name;
-		std::string ext;
+		std::string fileName;
+		FCM::U_Int64 start = SizeReport::Now();
 
 		bitmapElem.set_name("image");
 
@@ -746,61 +849,28 @@ namespace PixiJS
 		bitmapElem.push_back(JSONNode("height", height));
 		bitmapElem.push_back(JSONNode("width", width));
 
-		FCM::AutoPtr<FCM::IFCMUnknown> pUnk;
-
-		FCM::Boolean alreadyExported = GetImageExportFileName(libPathName, name);
-
-		if (!alreadyExported)
+		res = ExportBitmap(libPathName, pMediaItem, width, height, name, fileName);
+		if (FCM_FAILURE_CODE(res))
 		{
-			if (m_images && !m_imageFolderCreated)
-			{
-				res = Utils::CreateDir(m_outputImageFolder, m_pCallback);
-				if (!(FCM_SUCCESS_CODE(res)))
-				{
-					Utils::Trace(m_pCallback, "ERROR: Output image folder (%s) could not be created\n", m_outputImageFolder.c_str());
-					return res;
-				}
-				m_imageFolderCreated = true;
-			}
-			Utils::GetFileExtension(libPathName, ext);
-			Utils::GetFileNameWithoutExtension(libPathName, name);
-			SetImageExportFileName(libPathName, name);
-
-			if (ext == "")
-			{
-				ext = "png";
-			}
+			return res;
 		}
 
-		std::string bitmapExportPath(m_outputImageFolder + name + "." + ext);
-		std::string bitmapRelPath(m_imagesPath + name + "." + ext);
-
-		res = m_pCallback->GetService(DOM::FLA_BITMAP_SERVICE, pUnk.m_Ptr);
-		ASSERT(FCM_SUCCESS_CODE(res));
-
-		FCM::AutoPtr<DOM::Service::Image::IBitmapExportService> bitmapExportService = pUnk;
-		if (m_images && bitmapExportService)
-		{
-			FCM::AutoPtr<FCM::IFCMCalloc> pCalloc;
-#ifdef _WINDOWS
-			fs::path exportPath(bitmapExportPath);
-			FCM::StringRep16 pFilePath = Utils::ToString16(fs::canonical(exportPath).string(), m_pCallback);
-#else
-			FCM::StringRep16 pFilePath = Utils::ToString16(bitmapExportPath, m_pCallback);
-#endif
-			res = bitmapExportService->ExportToFile(pMediaItem, pFilePath, 100);
-			ASSERT(FCM_SUCCESS_CODE(res));
-
-			pCalloc = Utils::GetCallocService(m_pCallback);
-			ASSERT(pCalloc.m_Ptr != NULL);
-
-			pCalloc->Free(pFilePath);
-		}
+		std::string bitmapRelPath(m_imagesPath + fileName);
 
 		bitmapElem.push_back(JSONNode("src", bitmapRelPath));
 		bitmapElem.push_back(JSONNode("name", name));
 
-		m_pBitmapArray->push_back(bitmapElem);
+		m_pDataWriter->Write(DataWriter::BITMAPS, bitmapElem, resId);
+
+		if (m_pSizeReport)
+		{
+			m_pSizeReport->SetName(DataWriter::BITMAPS, resId, libPathName);
+			if (m_images)
+			{
+				m_pSizeReport->AddFile(DataWriter::BITMAPS, resId, m_outputImageFolder + fileName);
+			}
+		}
+		AddDefineTime(DataWriter::BITMAPS, resId, start);
 
 		return FCM_SUCCESS;
 	}
@@ -821,6 +891,9 @@ namespace PixiJS
 		m_pTextElem->set_name("text");
 		m_pTextElem->push_back(JSONNode("assetId", resId));
 
+		m_defineStart = SizeReport::Now();
+		m_textId = resId;
+
 		aaMode.set_name("aaMode");
 		aaMode.push_back(JSONNode("mode", Utils::ToString(aaModeProp.aaMode)));
 		if (aaModeProp.aaMode == DOM::FrameElement::ANTI_ALIAS_MODE_CUSTOM)
@@ -963,7 +1036,8 @@ namespace PixiJS
 		delete m_pTextParaArray;
 		m_pTextParaArray = NULL;
 
-		m_pTextArray->push_back(*m_pTextElem);
+		m_pDataWriter->Write(DataWriter::TEXTS, *m_pTextElem, m_textId);
+		AddDefineTime(DataWriter::TEXTS, m_textId, m_defineStart);
 
 		delete m_pTextElem;
 		m_pTextElem = NULL;
@@ -981,6 +1055,7 @@ namespace PixiJS
 		JSONNode soundElem(JSON_NODE);
 		std::string name;
 		std::string ext;
+		FCM::U_Int64 start = SizeReport::Now();
 
 		soundElem.set_name("sound");
 		soundElem.push_back(JSONNode("assetId", resId));
@@ -1026,7 +1101,14 @@ namespace PixiJS
 		soundElem.push_back(JSONNode("src", soundRelPath));
 		soundElem.push_back(JSONNode("name", name));
 
-		m_pSoundArray->push_back(soundElem);
+		m_pDataWriter->Write(DataWriter::SOUNDS, soundElem, resId);
+
+		if (m_pSizeReport)
+		{
+			m_pSizeReport->SetName(DataWriter::SOUNDS, resId, libPathName);
+			m_pSizeReport->AddFile(DataWriter::SOUNDS, resId, soundExportPath);
+		}
+		AddDefineTime(DataWriter::SOUNDS, resId, start);
 
 		return FCM_SUCCESS;
 	}
@@ -1048,12 +1130,23 @@ namespace PixiJS
 		bool images,
 		bool sounds,
 		bool compactShapes,
+		bool packShapes,
+		double shapeGrid,
 		bool compressJS,
 		bool loopTimeline,
 		bool spritesheets,
 		int spritesheetSize,
-		double spritesheetScale)
-		: m_pCallback(pCallback),
+		double spritesheetScale,
+		bool streamData,
+		bool compilerServer,
+		bool assetCache,
+		const std::string& documentPath,
+		bool browserPreview,
+		bool sizeReport,
+		int seekInterval,
+		bool tweenMoves)
+		: m_pCompiler(NULL),
+		m_pCallback(pCallback),
 		m_outputFile(outputFile),
 		m_outputVersion(outputVersion),
 		m_outputFormat(outputFormat),
@@ -1072,6 +1165,8 @@ namespace PixiJS
 		m_images(images),
 		m_sounds(sounds),
 		m_compactShapes(compactShapes),
+		m_packShapes(packShapes),
+		m_shapeGrid(shapeGrid),
 		m_compressJS(compressJS),
 		m_loopTimeline(loopTimeline),
 		m_spritesheets(spritesheets),
@@ -1080,33 +1175,48 @@ namespace PixiJS
 		m_shapeElem(NULL),
 		m_pathArray(NULL),
 		m_pathElem(NULL),
+		m_pathCmdArray(NULL),
+		m_lastGridX(0),
+		m_lastGridY(0),
 		m_firstSegment(false),
+		m_bitmapExportsAvoided(0),
+		m_pAssetCache(NULL),
+		m_cachedBitmapCount(0),
+		m_pSizeReport(NULL),
+		m_defineStart(0),
+		m_pathSegmentCount(0),
+		m_textId(0),
+		m_dedupShapeCount(0),
+		m_deadCommandCount(0),
+		m_dedupShapeBytes(0),
 		m_symbolNameLabel(0),
 		m_imageFolderCreated(false),
-		m_soundFolderCreated(false)
+		m_soundFolderCreated(false),
+		m_streamData(streamData),
+		m_compilerServer(compilerServer),
+		m_browserPreview(browserPreview),
+		m_seekInterval(seekInterval),
+		m_tweenMoves(tweenMoves)
 	{
-		m_pRootNode = new JSONNode(JSON_NODE);
-		ASSERT(m_pRootNode);
+		m_pDataWriter = new DataWriter(m_outputDataFile, pCallback);
+		ASSERT(m_pDataWriter);
 
-		m_pShapeArray = new JSONNode(JSON_ARRAY);
-		ASSERT(m_pShapeArray);
-		m_pShapeArray->set_name("Shapes");
+		if (assetCache)
+		{
+			m_pAssetCache = new AssetCache(pCallback);
+			ASSERT(m_pAssetCache);
 
-		m_pTimelineArray = new JSONNode(JSON_ARRAY);
-		ASSERT(m_pTimelineArray);
-		m_pTimelineArray->set_name("Timelines");
+			m_pAssetCache->Load(m_outputDataFile, documentPath);
+		}
 
-		m_pBitmapArray = new JSONNode(JSON_ARRAY);
-		ASSERT(m_pBitmapArray);
-		m_pBitmapArray->set_name("Bitmaps");
+		if (sizeReport)
+		{
+			m_pSizeReport = new SizeReport(pCallback);
+			ASSERT(m_pSizeReport);
 
-		m_pTextArray = new JSONNode(JSON_ARRAY);
-		ASSERT(m_pTextArray);
-		m_pTextArray->set_name("Texts");
+			m_pDataWriter->SetSizeReport(m_pSizeReport);
+		}
 
-		m_pSoundArray = new JSONNode(JSON_ARRAY);
-		ASSERT(m_pSoundArray);
-		m_pSoundArray->set_name("Sounds");
 		m_strokeStyle.type = INVALID_STROKE_STYLE_TYPE;
 
 		m_pTweenArray = NULL;
@@ -1114,17 +1224,53 @@ namespace PixiJS
 
 	OutputWriter::~OutputWriter()
 	{
-		delete m_pBitmapArray;
-		delete m_pSoundArray;
-		delete m_pTimelineArray;
-		delete m_pShapeArray;
-		delete m_pTextArray;
-		delete m_pRootNode;
+		// The data writer's workers add to the size report
+		delete m_pDataWriter;
+		delete m_pAssetCache;
+		delete m_pSizeReport;
+
+		// Publish was cancelled after the compiler started, it only has
+		// part of the document
+		delete m_pCompiler;
+	}
+
+	std::string OutputWriter::GetCompilerPath() const
+	{
+		std::string extensionPath;
+		Utils::GetExtensionPath(extensionPath, m_pCallback);
+		return extensionPath + NODE_COMPILER;
+	}
+
+	std::string OutputWriter::GetCompilerArgs() const
+	{
+		std::string publish = "\"" + GetCompilerPath() + "\" --src \"" + m_outputDataFile + "\"";
+
+#ifdef _DEBUG
+		publish += " --debug";
+#endif
+		return publish;
 	}
 
 	FCM::Result OutputWriter::StartPreview(FCM::PIFCMCallback pCallback)
 	{
 		FCM::Result res = FCM_SUCCESS;
+
+#ifdef USE_HTTP_SERVER
+		if (m_browserPreview)
+		{
+			// Open pages reload in place, no app to start
+			PreviewServer& server = PreviewServer::GetInstance();
+			if (server.Serve(m_basePath, pCallback))
+			{
+				server.Reload(m_basePath);
+			}
+			else if (server.GetPort() >= 0)
+			{
+				Utils::LaunchBrowser(m_htmlPath, server.GetPort(), pCallback);
+			}
+			return res;
+		}
+#endif
 		std::string cmd;
 		std::string extensionPath;
 		Utils::GetExtensionPath(extensionPath, m_pCallback);
@@ -1141,7 +1287,7 @@ namespace PixiJS
 #ifdef _DEBUG
 		preview += " --devTools";
 #endif
-		Utils::RunElectron(preview);
+		res = PreviewWindow::GetInstance().Show(preview, pCallback);
 		return res;
 	}
 
@@ -1149,33 +1295,223 @@ namespace PixiJS
 	{
 		FCM::Result res = FCM_SUCCESS;
 
+		// Only the preview this plugin started, other electron apps are left alone
+		PreviewWindow::GetInstance().Stop();
+		return res;
+	}
+
+	FCM::U_Int32 OutputWriter::AddStyle(
+		DataWriter::Section section,
+		std::map<std::string, FCM::U_Int32>& table,
+		const JSONNode& style)
+	{
+		std::string key = style.write();
+
+		std::map<std::string, FCM::U_Int32>::iterator it = table.find(key);
+		if (it != table.end())
+		{
+			return it->second;
+		}
+
+		FCM::U_Int32 index = (FCM::U_Int32)table.size();
+		table.insert(std::pair<std::string, FCM::U_Int32>(key, index));
+		m_pDataWriter->Write(section, style);
+
+		return index;
+	}
+
+	void OutputWriter::SetFillStyle(const JSONNode& style)
+	{
+		m_pathElem->push_back(JSONNode("fill", AddStyle(DataWriter::FILL_STYLES, m_fillStyles, style)));
+	}
+
+	void OutputWriter::StartPathCommands()
+	{
+		// Deltas start from the origin for each fill or stroke
+		m_lastGridX = 0;
+		m_lastGridY = 0;
+
+		if (m_packShapes)
+		{
+			m_pathEncoder.Clear();
+			return;
+		}
+
+		m_pathCmdArray = new JSONNode(JSON_ARRAY);
+		ASSERT(m_pathCmdArray);
+		m_pathCmdArray->set_name("d");
+	}
+
+	void OutputWriter::AddPathCommand(PathEncoder::Command command, const std::string& key)
+	{
+		if (command == PathEncoder::LINE_TO || command == PathEncoder::QUADRATIC_CURVE_TO)
+		{
+			m_pathSegmentCount++;
+		}
+
+		if (m_packShapes)
+		{
+			m_pathEncoder.AddCommand(command);
+		}
+		else
+		{
+			m_pathCmdArray->push_back(JSONNode("", key));
+		}
+	}
+
+	void OutputWriter::AddPathPoint(const DOM::Utils::POINT2D& point)
+	{
+		if (m_shapeGrid > 0)
+		{
+			FCM::S_Int32 gridX = (FCM::S_Int32)floor(point.x / m_shapeGrid + 0.5);
+			FCM::S_Int32 gridY = (FCM::S_Int32)floor(point.y / m_shapeGrid + 0.5);
+			FCM::S_Int32 dx = gridX - m_lastGridX;
+			FCM::S_Int32 dy = gridY - m_lastGridY;
+
+			m_lastGridX = gridX;
+			m_lastGridY = gridY;
+
+			if (m_packShapes)
+			{
+				m_pathEncoder.AddPointDelta(dx, dy);
+			}
+			else
+			{
+				m_pathCmdArray->push_back(JSONNode("", dx));
+				m_pathCmdArray->push_back(JSONNode("", dy));
+			}
+			return;
+		}
+
+		if (m_packShapes)
+		{
+			m_pathEncoder.AddPoint(point.x, point.y);
+		}
+		else
+		{
+			m_pathCmdArray->push_back(JSONNode("", Utils::Round(point.x, PATH_PRECISION)));
+			m_pathCmdArray->push_back(JSONNode("", Utils::Round(point.y, PATH_PRECISION)));
+		}
+	}
+
+	void OutputWriter::EndPathCommands()
+	{
+		if (m_packShapes)
+		{
+			// Packed paths are a base64 string instead of an array
+			m_pathElem->push_back(JSONNode("d", m_pathEncoder.ToBase64()));
+			return;
+		}
+
+		m_pathElem->push_back(*m_pathCmdArray);
+
+		delete m_pathCmdArray;
+		m_pathCmdArray = NULL;
+	}
+
+	void OutputWriter::AddDefineTime(DataWriter::Section section, FCM::U_Int32 assetId, FCM::U_Int64 start)
+	{
+		if (m_pSizeReport)
+		{
+			m_pSizeReport->AddTime(section, assetId, SizeReport::Now() - start);
+		}
+	}
+
+	FCM::Result OutputWriter::ExportBitmap(
+		const std::string& libPathName,
+		DOM::LibraryItem::PIMediaItem pMediaItem,
+		FCM::S_Int32 width,
+		FCM::S_Int32 height,
+		std::string& name,
+		std::string& fileName)
+	{
+		FCM::Result res;
+		std::string ext;
+
+		if (GetImageExportFileName(libPathName, fileName))
+		{
+			// Written by an earlier fill or bitmap, don't encode it again
+			Utils::GetFileNameWithoutExtension(fileName, name);
+
+			// Nothing would have been exported without images
+			if (m_images)
+			{
+				m_bitmapExportsAvoided++;
+			}
+			return FCM_SUCCESS;
+		}
+
+		if (m_images && !m_imageFolderCreated)
+		{
+			res = Utils::CreateDir(m_outputImageFolder, m_pCallback);
+			if (!(FCM_SUCCESS_CODE(res)))
+			{
+				Utils::Trace(m_pCallback, "ERROR: Output image folder (%s) could not be created\n", m_outputImageFolder.c_str());
+				return res;
+			}
+			m_imageFolderCreated = true;
+		}
+		Utils::GetFileExtension(libPathName, ext);
+		Utils::GetFileNameWithoutExtension(libPathName, name);
+
+		if (ext == "")
+		{
+			ext = "png";
+		}
+		fileName = name + "." + ext;
+		SetImageExportFileName(libPathName, fileName);
+
+		std::string bitmapExportPath(m_outputImageFolder + fileName);
+
+		// Same size in the same saved document and the file is still there
+		std::string signature = "bitmap " + Utils::ToString(width) + "x" + Utils::ToString(height);
+		if (m_images && m_pAssetCache && m_pAssetCache->IsCurrent(libPathName, signature, bitmapExportPath))
+		{
+			m_cachedBitmapCount++;
+			return FCM_SUCCESS;
+		}
+
+		FCM::AutoPtr<FCM::IFCMUnknown> pUnk;
+		res = m_pCallback->GetService(DOM::FLA_BITMAP_SERVICE, pUnk.m_Ptr);
+		ASSERT(FCM_SUCCESS_CODE(res));
+
+		FCM::AutoPtr<DOM::Service::Image::IBitmapExportService> bitmapExportService = pUnk;
+		if (m_images && bitmapExportService)
+		{
+			FCM::AutoPtr<FCM::IFCMCalloc> pCalloc;
 #ifdef _WINDOWS
-		// currently this operation is not supported on windows!
+			fs::path exportPath(bitmapExportPath);
+			FCM::StringRep16 pFilePath = Utils::ToString16(fs::canonical(exportPath).string(), m_pCallback);
 #else
-		// ps aux find's everything that's running
-		// grep is searching for any process with the string 'electron' followed by the parent directory.
-		//   (excluding the grep process itself)
-		// awk is printing the second string returned by the grep (which is the pid)
-		// kill is operating over all pids returned in this way
-		std::string extensionPath;
-		Utils::GetExtensionPath(extensionPath, m_pCallback);
-		std::string preview = extensionPath + PREVIEW_APP;
-		std::string cmd = "kill $(ps aux | grep '\\<.*[e]lectron.*\\> " + preview + "' | awk '{print $2}')";
-		popen(cmd.c_str(), "r");
-#endif // _WINDOWS
-		return res;
+			FCM::StringRep16 pFilePath = Utils::ToString16(bitmapExportPath, m_pCallback);
+#endif
+			res = bitmapExportService->ExportToFile(pMediaItem, pFilePath, 100);
+			ASSERT(FCM_SUCCESS_CODE(res));
+
+			pCalloc = Utils::GetCallocService(m_pCallback);
+			ASSERT(pCalloc.m_Ptr != NULL);
+
+			pCalloc->Free(pFilePath);
+
+			if (m_pAssetCache)
+			{
+				m_pAssetCache->Update(libPathName, signature, bitmapExportPath);
+			}
+		}
+
+		return FCM_SUCCESS;
 	}
 
-	FCM::Boolean OutputWriter::GetImageExportFileName(const std::string& libPathName, std::string& name)
+	FCM::Boolean OutputWriter::GetImageExportFileName(const std::string& libPathName, std::string& fileName)
 	{
 		std::map<std::string, std::string>::iterator it = m_imageMap.find(libPathName);
 
-		name = "";
+		fileName = "";
 
 		if (it != m_imageMap.end())
 		{
 			// Image already exported
-			name = it->second;
+			fileName = it->second;
 			return true;
 		}
 
@@ -1183,12 +1519,12 @@ namespace PixiJS
 	}
 
 
-	void OutputWriter::SetImageExportFileName(const std::string& libPathName, const std::string& name)
+	void OutputWriter::SetImageExportFileName(const std::string& libPathName, const std::string& fileName)
 	{
 		// Assumption: Name is not already present in the map
 		ASSERT(m_imageMap.find(libPathName) == m_imageMap.end());
 
-		m_imageMap.insert(std::pair<std::string, std::string>(libPathName, name));
+		m_imageMap.insert(std::pair<std::string, std::string>(libPathName, fileName));
 	}
 
 	bool OutputWriter::SaveFromTemplate(const std::string &in, const std::string &out)
@@ -0,0 +1,96 @@
+//
+//  PathEncoder.cpp
+//  PixiAnimate.mp
+//
+//  Packs the drawing commands of a shape path into a byte stream,
+//  used instead of a JSON array when packed shapes are enabled.
+//
+
+#include "PathEncoder.h"
+#include "libjson.h"
+
+#include <cstring>
+
+namespace PixiJS
+{
+	PathEncoder::PathEncoder()
+		: m_pendingMove(false)
+	{
+	}
+
+	void PathEncoder::Clear()
+	{
+		m_buffer.clear();
+		m_pendingMove = false;
+	}
+
+	void PathEncoder::AddCommand(Command command)
+	{
+		if (command == MOVE_TO)
+		{
+			m_pendingMove = true;
+			return;
+		}
+
+		// A move without a point draws nothing, drop it
+		m_pendingMove = false;
+		m_buffer.push_back((unsigned char)command);
+	}
+
+	void PathEncoder::AddPoint(double x, double y)
+	{
+		FlushMove();
+		WriteFloat((float)x);
+		WriteFloat((float)y);
+	}
+
+	void PathEncoder::AddPointDelta(int dx, int dy)
+	{
+		FlushMove();
+		WriteVarint(dx);
+		WriteVarint(dy);
+	}
+
+	std::string PathEncoder::ToBase64() const
+	{
+		if (m_buffer.empty())
+		{
+			return "";
+		}
+		return libjson::encode64(&m_buffer[0], m_buffer.size());
+	}
+
+	void PathEncoder::WriteFloat(float value)
+	{
+		// Write byte by byte so the stream is little-endian on every platform
+		unsigned int bits;
+		memcpy(&bits, &value, sizeof(bits));
+
+		m_buffer.push_back((unsigned char)(bits & 0xFF));
+		m_buffer.push_back((unsigned char)((bits >> 8) & 0xFF));
+		m_buffer.push_back((unsigned char)((bits >> 16) & 0xFF));
+		m_buffer.push_back((unsigned char)((bits >> 24) & 0xFF));
+	}
+
+	void PathEncoder::WriteVarint(int value)
+	{
+		// Zig-zag so small negative deltas stay small
+		unsigned int bits = ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+
+		while (bits >= 0x80)
+		{
+			m_buffer.push_back((unsigned char)((bits & 0x7F) | 0x80));
+			bits >>= 7;
+		}
+		m_buffer.push_back((unsigned char)bits);
+	}
+
+	void PathEncoder::FlushMove()
+	{
+		if (m_pendingMove)
+		{
+			m_buffer.push_back((unsigned char)MOVE_TO);
+			m_pendingMove = false;
+		}
+	}
+};
@@ -0,0 +1,483 @@
+//
+//  PreviewServer.cpp
+//  PixiAnimate.mp
+//
+//  Serves the published output to a browser on a local port, and tells
+//  the open pages to reload when the output is published again.
+//
+
+#ifdef USE_HTTP_SERVER
+
+#include "PreviewServer.h"
+
+#ifdef _WINDOWS
+#include "Windows.h"
+#endif
+
+#ifdef __APPLE__
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#endif
+
+#include <cctype>
+#include <cstring>
+#include <cstdlib>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
+
+// Path the pages listen on for reload events
+#define RELOAD_EVENTS_PATH "/__reload"
+
+// Largest request header accepted
+#define MAX_REQUEST_SIZE 16384
+
+// Time a connection gets to send its request
+#define REQUEST_TIMEOUT 5000
+
+// Added to every HTML page served, reloads it on a reload event
+static const char* reloadScript =
+	"<script>new EventSource('" RELOAD_EVENTS_PATH "').onmessage = function() { location.reload(); };</script>\n";
+
+namespace PixiJS
+{
+	static bool SendAll(SOCKET sock, const std::string& data)
+	{
+		size_t sent = 0;
+		while (sent < data.size())
+		{
+			int count = send(sock, data.c_str() + sent, (int)(data.size() - sent), 0);
+			if (count <= 0)
+			{
+				return false;
+			}
+			sent += count;
+		}
+		return true;
+	}
+
+	static void SendStatus(SOCKET sock, const std::string& status)
+	{
+		SendAll(sock, "HTTP/1.1 " + status + "\r\n"
+			"Content-Length: 0\r\n"
+			"Connection: close\r\n\r\n");
+	}
+
+	static std::string GetContentType(const std::string& path)
+	{
+		// Utils::GetFileExtension keeps only 3 letters
+		size_t dot = path.find_last_of('.');
+		std::string extension = dot == std::string::npos ? "" : path.substr(dot + 1);
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+		if (extension == "html" || extension == "htm") return "text/html; charset=utf-8";
+		if (extension == "js") return "application/javascript; charset=utf-8";
+		if (extension == "json") return "application/json; charset=utf-8";
+		if (extension == "css") return "text/css; charset=utf-8";
+		if (extension == "png") return "image/png";
+		if (extension == "jpg" || extension == "jpeg") return "image/jpeg";
+		if (extension == "gif") return "image/gif";
+		if (extension == "svg") return "image/svg+xml";
+		if (extension == "mp3") return "audio/mpeg";
+		if (extension == "ogg") return "audio/ogg";
+		if (extension == "wav") return "audio/wav";
+		if (extension == "m4a") return "audio/mp4";
+		return "application/octet-stream";
+	}
+
+	// Decode %XX escapes, false for anything that could leave the folder
+	static bool DecodePath(const std::string& url, std::string& path)
+	{
+		path.clear();
+		for (size_t i = 0; i < url.size(); i++)
+		{
+			if (url[i] == '%' && i + 2 < url.size() && isxdigit(url[i + 1]) && isxdigit(url[i + 2]))
+			{
+				path += (char)strtol(url.substr(i + 1, 2).c_str(), NULL, 16);
+				i += 2;
+			}
+			else
+			{
+				path += url[i];
+			}
+		}
+
+		return path.find("..") == std::string::npos &&
+			path.find('\\') == std::string::npos &&
+			path.find('\0') == std::string::npos;
+	}
+
+	// Get the value of a header, names are matched without case
+	static std::string GetHeader(const std::string& request, const std::string& name)
+	{
+		std::string lower = request;
+		std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+
+		size_t pos = lower.find("\r\n" + name + ":");
+		if (pos == std::string::npos)
+		{
+			return "";
+		}
+
+		pos += name.size() + 3;
+		size_t end = request.find("\r\n", pos);
+		std::string value = request.substr(pos, end - pos);
+		value.erase(0, value.find_first_not_of(" \t"));
+		return value;
+	}
+
+	// Request paths start with a separator, the folder shouldn't end with one
+	static std::string TrimSeparator(const std::string& folder)
+	{
+		std::string trimmed = folder;
+		if (!trimmed.empty() && (trimmed[trimmed.size() - 1] == '/' || trimmed[trimmed.size() - 1] == '\\'))
+		{
+			trimmed.erase(trimmed.size() - 1);
+		}
+		return trimmed;
+	}
+
+	PreviewServer& PreviewServer::GetInstance()
+	{
+		static PreviewServer server;
+		return server;
+	}
+
+	PreviewServer::PreviewServer()
+		: m_port(-1),
+		m_listenSocket((SOCKET)-1),
+		m_stopping(false),
+		m_activeCount(0),
+		m_pCallback(NULL)
+	{
+	}
+
+	PreviewServer::~PreviewServer()
+	{
+		Stop();
+	}
+
+	bool PreviewServer::Serve(const std::string& rootFolder, FCM::PIFCMCallback pCallback)
+	{
+		std::string root = TrimSeparator(rootFolder);
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			if (m_listener.joinable())
+			{
+				if (m_root == root)
+				{
+					PruneClients();
+					return !m_clients.empty();
+				}
+
+				// The pages open on the other folder keep what they show
+				for (size_t i = 0; i < m_clients.size(); i++)
+				{
+					CLOSE_SOCKET(m_clients[i]);
+				}
+				m_clients.clear();
+				m_root = root;
+				return false;
+			}
+		}
+
+		if (!Utils::StartSockets())
+		{
+			return false;
+		}
+
+		m_listenSocket = socket(PF_INET, SOCK_STREAM, 0);
+		if (m_listenSocket == (SOCKET)-1)
+		{
+			return false;
+		}
+
+		// Port 0 picks a free port, read back once bound
+		sockaddr_in address;
+		Utils::InitSockAddr(&address);
+		address.sin_port = 0;
+
+#ifdef _WINDOWS
+		int addressSize = sizeof(address);
+#else
+		socklen_t addressSize = sizeof(address);
+#endif
+		if (bind(m_listenSocket, (struct sockaddr *) &address, sizeof(address)) != 0 ||
+			listen(m_listenSocket, 16) != 0 ||
+			getsockname(m_listenSocket, (struct sockaddr *) &address, &addressSize) != 0)
+		{
+			Utils::Trace(pCallback, "ERROR: Preview server could not be started\n");
+			CLOSE_SOCKET(m_listenSocket);
+			m_listenSocket = (SOCKET)-1;
+			return false;
+		}
+
+		m_port = ntohs(address.sin_port);
+		m_root = root;
+		m_pCallback = pCallback;
+		m_stopping = false;
+		m_listener = std::thread(&PreviewServer::Listen, this);
+
+		return false;
+	}
+
+	void PreviewServer::Reload(const std::string& rootFolder)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (m_root.empty() || m_root != TrimSeparator(rootFolder))
+		{
+			return;
+		}
+
+		std::vector<SOCKET> open;
+		for (size_t i = 0; i < m_clients.size(); i++)
+		{
+			if (SendAll(m_clients[i], "data: reload\n\n"))
+			{
+				open.push_back(m_clients[i]);
+			}
+			else
+			{
+				CLOSE_SOCKET(m_clients[i]);
+			}
+		}
+		m_clients.swap(open);
+	}
+
+	void PreviewServer::Stop()
+	{
+		if (!m_listener.joinable())
+		{
+			return;
+		}
+
+		m_stopping = true;
+		m_listener.join();
+
+		CLOSE_SOCKET(m_listenSocket);
+		m_listenSocket = (SOCKET)-1;
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		// Requests in progress hold a pointer to this server
+		while (m_activeCount > 0)
+		{
+			m_connectionDone.wait(lock);
+		}
+
+		for (size_t i = 0; i < m_clients.size(); i++)
+		{
+			CLOSE_SOCKET(m_clients[i]);
+		}
+		m_clients.clear();
+		m_root.clear();
+		m_port = -1;
+	}
+
+	int PreviewServer::GetPort() const
+	{
+		return m_port;
+	}
+
+	void PreviewServer::Listen()
+	{
+		while (!m_stopping)
+		{
+			// Wake up now and then to see if the server should stop
+			fd_set readSet;
+			FD_ZERO(&readSet);
+			FD_SET(m_listenSocket, &readSet);
+
+			struct timeval timeout;
+			timeout.tv_sec = 0;
+			timeout.tv_usec = 200000;
+
+			if (select((int)m_listenSocket + 1, &readSet, NULL, NULL, &timeout) <= 0)
+			{
+				continue;
+			}
+
+			SOCKET sock = accept(m_listenSocket, NULL, NULL);
+			if (sock == (SOCKET)-1)
+			{
+				continue;
+			}
+
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_activeCount++;
+			}
+
+			// Browsers open connections they may never use, don't let
+			// one hold up the others
+			std::thread(&PreviewServer::HandleConnection, this, sock).detach();
+		}
+	}
+
+	void PreviewServer::HandleConnection(SOCKET sock)
+	{
+#ifdef _WINDOWS
+		DWORD timeout = REQUEST_TIMEOUT;
+#else
+		struct timeval timeout;
+		timeout.tv_sec = REQUEST_TIMEOUT / 1000;
+		timeout.tv_usec = 0;
+#endif
+		setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+
+#ifdef SO_NOSIGPIPE
+		// A page that went away must fail the send, not kill the host
+		int noSigPipe = 1;
+		setsockopt(sock, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+		std::string request;
+		char buffer[2048];
+		while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_SIZE)
+		{
+			int count = recv(sock, buffer, sizeof(buffer), 0);
+			if (count <= 0)
+			{
+				break;
+			}
+			request.append(buffer, count);
+		}
+
+		bool keepOpen = false;
+
+		// Request line is "METHOD /path?query HTTP/1.1"
+		std::stringstream line(request.substr(0, request.find("\r\n")));
+		std::string method;
+		std::string url;
+		line >> method >> url;
+		url = url.substr(0, url.find('?'));
+
+		std::string path;
+		if (request.find("\r\n\r\n") == std::string::npos)
+		{
+			// Closed or timed out before the request was complete
+		}
+		else if (method != "GET" && method != "HEAD")
+		{
+			SendStatus(sock, "405 Method Not Allowed");
+		}
+		else if (url == RELOAD_EVENTS_PATH)
+		{
+			// Kept open, the reload events are written to it later
+			keepOpen = SendAll(sock, "HTTP/1.1 200 OK\r\n"
+				"Content-Type: text/event-stream\r\n"
+				"Cache-Control: no-cache\r\n"
+				"Connection: keep-alive\r\n\r\n");
+		}
+		else if (url.empty() || url[0] != '/' || !DecodePath(url, path))
+		{
+			SendStatus(sock, "400 Bad Request");
+		}
+		else
+		{
+			ServeFile(sock, path, request, method == "HEAD");
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (keepOpen && !m_stopping)
+		{
+			m_clients.push_back(sock);
+		}
+		else
+		{
+			CLOSE_SOCKET(sock);
+		}
+
+		m_activeCount--;
+		m_connectionDone.notify_all();
+	}
+
+	void PreviewServer::ServeFile(SOCKET sock, const std::string& path, const std::string& request, bool head)
+	{
+		std::fstream file;
+		Utils::OpenFStream(GetRoot() + path, file, std::ios_base::in | std::ios_base::binary, m_pCallback);
+		if (!file.is_open())
+		{
+			SendStatus(sock, "404 Not Found");
+			return;
+		}
+
+		std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		file.close();
+
+		std::string contentType = GetContentType(path);
+		if (contentType.find("text/html") == 0)
+		{
+			size_t bodyEnd = content.rfind("</body>");
+			content.insert(bodyEnd == std::string::npos ? content.size() : bodyEnd, reloadScript);
+		}
+
+		// Always checked with the server, unchanged files are not sent again
+		std::stringstream etag;
+		etag << "\"" << std::hex << Utils::Hash(content) << "\"";
+
+		if (GetHeader(request, "if-none-match") == etag.str())
+		{
+			SendAll(sock, "HTTP/1.1 304 Not Modified\r\n"
+				"ETag: " + etag.str() + "\r\n"
+				"Cache-Control: no-cache\r\n"
+				"Connection: close\r\n\r\n");
+			return;
+		}
+
+		std::stringstream header;
+		header << "HTTP/1.1 200 OK\r\n"
+			<< "Content-Type: " << contentType << "\r\n"
+			<< "Content-Length: " << content.size() << "\r\n"
+			<< "ETag: " << etag.str() << "\r\n"
+			<< "Cache-Control: no-cache\r\n"
+			<< "Connection: close\r\n\r\n";
+
+		if (SendAll(sock, header.str()) && !head)
+		{
+			SendAll(sock, content);
+		}
+	}
+
+	void PreviewServer::PruneClients()
+	{
+		std::vector<SOCKET> open;
+		for (size_t i = 0; i < m_clients.size(); i++)
+		{
+			fd_set readSet;
+			FD_ZERO(&readSet);
+			FD_SET(m_clients[i], &readSet);
+
+			struct timeval timeout;
+			timeout.tv_sec = 0;
+			timeout.tv_usec = 0;
+
+			// Pages never send anything, readable means closed
+			char c;
+			if (select((int)m_clients[i] + 1, &readSet, NULL, NULL, &timeout) > 0 &&
+				recv(m_clients[i], &c, 1, MSG_PEEK) <= 0)
+			{
+				CLOSE_SOCKET(m_clients[i]);
+			}
+			else
+			{
+				open.push_back(m_clients[i]);
+			}
+		}
+		m_clients.swap(open);
+	}
+
+	std::string PreviewServer::GetRoot()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_root;
+	}
+};
+
+#endif // USE_HTTP_SERVER
@@ -0,0 +1,76 @@
+//
+//  PreviewWindow.cpp
+//  PixiAnimate.mp
+//
+//  Keeps track of the preview app started by the plugin, so publishing
+//  again reloads that window instead of starting a new one.
+//
+
+#include "PreviewWindow.h"
+#include "Process.h"
+#include "Utils.h"
+
+// Time for an open preview to answer a reload
+#define PREVIEW_RELOAD_TIMEOUT 1000
+
+namespace PixiJS
+{
+	PreviewWindow& PreviewWindow::GetInstance()
+	{
+		static PreviewWindow preview;
+		return preview;
+	}
+
+	PreviewWindow::PreviewWindow()
+		: m_port(-1),
+		m_pProcess(NULL)
+	{
+	}
+
+	PreviewWindow::~PreviewWindow()
+	{
+		Stop();
+	}
+
+	FCM::Result PreviewWindow::Show(const std::string& args, FCM::PIFCMCallback pCallback)
+	{
+		// The window was closed when the app doesn't answer
+		std::string reply;
+		if (m_pProcess != NULL && args == m_args && Utils::StartSockets() &&
+			Utils::SendRequest(m_port, "reload", reply, PREVIEW_RELOAD_TIMEOUT) && reply == "ok")
+		{
+			return FCM_SUCCESS;
+		}
+
+		Stop();
+
+		m_port = Utils::StartSockets() ? Utils::GetUnusedLocalPort() : -1;
+
+		std::string argline = args;
+		if (m_port >= 0)
+		{
+			argline += " --port " + Utils::ToString((FCM::S_Int32)m_port);
+		}
+
+		m_pProcess = Utils::OpenElectron(argline);
+		if (m_pProcess == NULL)
+		{
+			Utils::Trace(pCallback, "ERROR: Preview could not be started\n");
+			return FCM_GENERAL_ERROR;
+		}
+		m_args = args;
+
+		return FCM_SUCCESS;
+	}
+
+	void PreviewWindow::Stop()
+	{
+		if (m_pProcess != NULL)
+		{
+			// Only the app started here, with the helpers it started
+			m_pProcess->Kill();
+			delete m_pProcess;
+			m_pProcess = NULL;
+		}
+	}
+};
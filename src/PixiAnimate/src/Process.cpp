@@ -0,0 +1,465 @@
+//
+//  Process.cpp
+//  PixiAnimate.mp
+//
+//  Starts a child process without going through a shell, with optional
+//  pipes to its input and from its output, and ends it with its children.
+//
+
+#include "Process.h"
+
+#include <vector>
+#include <chrono>
+#include <cerrno>
+
+#ifdef _WINDOWS
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <spawn.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+
+extern char** environ;
+#endif
+
+// Output kept from a process, older output is dropped
+#define MAX_PROCESS_OUTPUT 65536
+
+// Time a process gets to end on its own before it is forced to
+#define PROCESS_KILL_TIMEOUT 2000
+
+namespace PixiJS
+{
+#ifndef _WINDOWS
+	// Split a command line the way the shell would for plain arguments,
+	// double quotes group words and a backslash escapes a quote in them
+	static void SplitArgs(const std::string& line, std::vector<std::string>& args)
+	{
+		std::string arg;
+		bool inArg = false;
+		bool quoted = false;
+
+		for (size_t i = 0; i < line.size(); i++)
+		{
+			char c = line[i];
+			if (quoted && c == '\\' && i + 1 < line.size() && (line[i + 1] == '"' || line[i + 1] == '\\'))
+			{
+				arg += line[++i];
+			}
+			else if (c == '"')
+			{
+				quoted = !quoted;
+				inArg = true;
+			}
+			else if (!quoted && (c == ' ' || c == '\t'))
+			{
+				if (inArg)
+				{
+					args.push_back(arg);
+					arg.clear();
+					inArg = false;
+				}
+			}
+			else
+			{
+				arg += c;
+				inArg = true;
+			}
+		}
+
+		if (inArg)
+		{
+			args.push_back(arg);
+		}
+	}
+
+	// Keep a pipe end from leaking into other processes started meanwhile
+	static void SetCloseOnExec(int fd)
+	{
+		fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+	}
+#endif
+
+	Process::Process()
+		: m_pInput(NULL),
+		m_running(false),
+#ifdef _WINDOWS
+		m_hProcess(NULL),
+		m_hJob(NULL),
+		m_hOutput(NULL)
+#else
+		m_pid(0),
+		m_outputFd(-1)
+#endif
+	{
+	}
+
+	Process::~Process()
+	{
+		if (m_running)
+		{
+			Kill();
+		}
+		Close();
+	}
+
+	bool Process::Start(const std::string& program, const std::string& args, int flags)
+	{
+#ifdef _WINDOWS
+		std::string cmd = program + " " + args;
+
+		int length = MultiByteToWideChar(CP_UTF8, 0, cmd.c_str(), -1, NULL, 0);
+		std::vector<wchar_t> wcmd(length);
+		MultiByteToWideChar(CP_UTF8, 0, cmd.c_str(), -1, &wcmd[0], length);
+
+		SECURITY_ATTRIBUTES sa;
+		ZeroMemory(&sa, sizeof(sa));
+		sa.nLength = sizeof(sa);
+		sa.bInheritHandle = TRUE;
+
+		// Only the child's ends of the pipes are inherited
+		HANDLE hInputRead = NULL;
+		HANDLE hInputWrite = NULL;
+		if ((flags & PIPE_INPUT) && CreatePipe(&hInputRead, &hInputWrite, &sa, 0))
+		{
+			SetHandleInformation(hInputWrite, HANDLE_FLAG_INHERIT, 0);
+		}
+
+		HANDLE hOutputRead = NULL;
+		HANDLE hOutputWrite = NULL;
+		if ((flags & CAPTURE_OUTPUT) && CreatePipe(&hOutputRead, &hOutputWrite, &sa, 0))
+		{
+			SetHandleInformation(hOutputRead, HANDLE_FLAG_INHERIT, 0);
+		}
+
+		STARTUPINFO si;
+		ZeroMemory(&si, sizeof(si));
+		si.cb = sizeof(si);
+		si.wShowWindow = SW_HIDE;
+		si.dwFlags = STARTF_USESHOWWINDOW | STARTF_USESTDHANDLES;
+		si.hStdInput = hInputRead ? hInputRead : GetStdHandle(STD_INPUT_HANDLE);
+		si.hStdOutput = hOutputWrite ? hOutputWrite : GetStdHandle(STD_OUTPUT_HANDLE);
+		si.hStdError = hOutputWrite ? hOutputWrite : GetStdHandle(STD_ERROR_HANDLE);
+
+		PROCESS_INFORMATION pi;
+		ZeroMemory(&pi, sizeof(pi));
+
+		// Suspended until it is in the job, so nothing it starts escapes
+		BOOL started = CreateProcess(NULL,
+			&wcmd[0],
+			NULL,
+			NULL,
+			TRUE,           // Inherit the child's ends of the pipes
+			CREATE_SUSPENDED,
+			NULL,
+			NULL,
+			&si,
+			&pi);
+
+		if (hInputRead) CloseHandle(hInputRead);
+		if (hOutputWrite) CloseHandle(hOutputWrite);
+
+		if (!started)
+		{
+			if (hInputWrite) CloseHandle(hInputWrite);
+			if (hOutputRead) CloseHandle(hOutputRead);
+			return false;
+		}
+
+		m_hJob = CreateJobObject(NULL, NULL);
+		if (m_hJob != NULL)
+		{
+			AssignProcessToJobObject(m_hJob, pi.hProcess);
+		}
+		ResumeThread(pi.hThread);
+		CloseHandle(pi.hThread);
+
+		m_hProcess = pi.hProcess;
+		m_running = true;
+
+		if (hInputWrite)
+		{
+			int fd = _open_osfhandle((intptr_t)hInputWrite, 0);
+			m_pInput = fd == -1 ? NULL : _fdopen(fd, "wb");
+			if (m_pInput == NULL)
+			{
+				CloseHandle(hInputWrite);
+			}
+		}
+
+		if (hOutputRead)
+		{
+			m_hOutput = hOutputRead;
+			m_reader = std::thread(&Process::ReadOutput, this);
+		}
+
+		return true;
+#else
+		std::vector<std::string> argStrings;
+		argStrings.push_back(program);
+		SplitArgs(args, argStrings);
+
+		std::vector<char*> argv;
+		for (size_t i = 0; i < argStrings.size(); i++)
+		{
+			argv.push_back(const_cast<char*>(argStrings[i].c_str()));
+		}
+		argv.push_back(NULL);
+
+		int inputPipe[2] = { -1, -1 };
+		int outputPipe[2] = { -1, -1 };
+
+		posix_spawn_file_actions_t actions;
+		posix_spawn_file_actions_init(&actions);
+
+		if ((flags & PIPE_INPUT) && pipe(inputPipe) == 0)
+		{
+			SetCloseOnExec(inputPipe[0]);
+			SetCloseOnExec(inputPipe[1]);
+			posix_spawn_file_actions_adddup2(&actions, inputPipe[0], STDIN_FILENO);
+		}
+
+		if ((flags & CAPTURE_OUTPUT) && pipe(outputPipe) == 0)
+		{
+			SetCloseOnExec(outputPipe[0]);
+			SetCloseOnExec(outputPipe[1]);
+			posix_spawn_file_actions_adddup2(&actions, outputPipe[1], STDOUT_FILENO);
+			posix_spawn_file_actions_adddup2(&actions, outputPipe[1], STDERR_FILENO);
+		}
+
+		// Its own process group, so Kill reaches everything it starts
+		posix_spawnattr_t attr;
+		posix_spawnattr_init(&attr);
+		posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+		posix_spawnattr_setpgroup(&attr, 0);
+
+		int err = posix_spawn(&m_pid, argv[0], &actions, &attr, &argv[0], environ);
+
+		posix_spawn_file_actions_destroy(&actions);
+		posix_spawnattr_destroy(&attr);
+
+		if (inputPipe[0] != -1) close(inputPipe[0]);
+		if (outputPipe[1] != -1) close(outputPipe[1]);
+
+		if (err != 0)
+		{
+			if (inputPipe[1] != -1) close(inputPipe[1]);
+			if (outputPipe[0] != -1) close(outputPipe[0]);
+			m_pid = 0;
+			return false;
+		}
+		m_running = true;
+
+		if (inputPipe[1] != -1)
+		{
+			m_pInput = fdopen(inputPipe[1], "w");
+#ifdef F_SETNOSIGPIPE
+			// A process that died early must fail the write, not kill the host
+			fcntl(inputPipe[1], F_SETNOSIGPIPE, 1);
+#endif
+		}
+
+		if (outputPipe[0] != -1)
+		{
+			m_outputFd = outputPipe[0];
+			m_reader = std::thread(&Process::ReadOutput, this);
+		}
+
+		return true;
+#endif
+	}
+
+	FILE* Process::GetInput() const
+	{
+		return m_pInput;
+	}
+
+	void Process::CloseInput()
+	{
+		if (m_pInput != NULL)
+		{
+			fclose(m_pInput);
+			m_pInput = NULL;
+		}
+	}
+
+	bool Process::Wait(int timeoutMs, int& exitCode)
+	{
+		exitCode = -1;
+		if (!m_running)
+		{
+			return true;
+		}
+
+#ifdef _WINDOWS
+		if (WaitForSingleObject(m_hProcess, timeoutMs > 0 ? timeoutMs : INFINITE) == WAIT_TIMEOUT)
+		{
+			return false;
+		}
+
+		DWORD code;
+		GetExitCodeProcess(m_hProcess, &code);
+		exitCode = (int)code;
+#else
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		int status = 0;
+
+		while (true)
+		{
+			pid_t pid = waitpid(m_pid, &status, timeoutMs > 0 ? WNOHANG : 0);
+			if (pid == m_pid || (pid < 0 && errno != EINTR))
+			{
+				break;
+			}
+
+			if (pid == 0)
+			{
+				std::chrono::milliseconds waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+					std::chrono::steady_clock::now() - start);
+				if (waited.count() >= timeoutMs)
+				{
+					return false;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
+		}
+
+		exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+#endif
+
+		m_running = false;
+
+		// The rest of the output arrives once the pipe closes
+		if (m_reader.joinable())
+		{
+			m_reader.join();
+		}
+
+		return true;
+	}
+
+	void Process::Kill()
+	{
+		if (!m_running)
+		{
+			return;
+		}
+
+		int exitCode;
+
+#ifdef _WINDOWS
+		if (m_hJob != NULL)
+		{
+			TerminateJobObject(m_hJob, 1);
+		}
+		else
+		{
+			TerminateProcess(m_hProcess, 1);
+		}
+		Wait(0, exitCode);
+#else
+		kill(-m_pid, SIGTERM);
+		if (!Wait(PROCESS_KILL_TIMEOUT, exitCode))
+		{
+			kill(-m_pid, SIGKILL);
+			Wait(0, exitCode);
+		}
+#endif
+	}
+
+	void Process::Detach()
+	{
+		if (m_running)
+		{
+#ifndef _WINDOWS
+			// Nobody else will collect its exit status
+			pid_t pid = m_pid;
+			std::thread([pid]() {
+				int status;
+				waitpid(pid, &status, 0);
+			}).detach();
+#endif
+			m_running = false;
+		}
+
+		if (m_reader.joinable())
+		{
+			m_reader.detach();
+		}
+	}
+
+	std::string Process::GetOutput()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_output;
+	}
+
+	void Process::ReadOutput()
+	{
+		char buffer[4096];
+
+		while (true)
+		{
+#ifdef _WINDOWS
+			DWORD count = 0;
+			if (!ReadFile(m_hOutput, buffer, sizeof(buffer), &count, NULL) || count == 0)
+			{
+				break;
+			}
+#else
+			ssize_t count = read(m_outputFd, buffer, sizeof(buffer));
+			if (count < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (count <= 0)
+			{
+				break;
+			}
+#endif
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_output.append(buffer, count);
+			if (m_output.size() > MAX_PROCESS_OUTPUT)
+			{
+				m_output.erase(0, m_output.size() - MAX_PROCESS_OUTPUT);
+			}
+		}
+	}
+
+	void Process::Close()
+	{
+		CloseInput();
+
+		if (m_reader.joinable())
+		{
+			m_reader.join();
+		}
+
+#ifdef _WINDOWS
+		if (m_hOutput != NULL)
+		{
+			CloseHandle(m_hOutput);
+			m_hOutput = NULL;
+		}
+		if (m_hJob != NULL)
+		{
+			CloseHandle(m_hJob);
+			m_hJob = NULL;
+		}
+		if (m_hProcess != NULL)
+		{
+			CloseHandle(m_hProcess);
+			m_hProcess = NULL;
+		}
+#else
+		if (m_outputFd != -1)
+		{
+			close(m_outputFd);
+			m_outputFd = -1;
+		}
+#endif
+	}
+};
@@ -0,0 +1,225 @@
+//
+//  Profiler.cpp
+//  PixiAnimate.mp
+//
+//  Times the phases of a publish, writes them as a trace that can be
+//  opened in chrome://tracing and summarizes them in the publish log.
+//
+
+#include "Profiler.h"
+#include "libjson.h"
+#include "Utils.h"
+
+#include <algorithm>
+
+namespace PixiJS
+{
+	// Symbols listed in the publish log, the trace has all of them
+	static const FCM::U_Int32 MAX_LOGGED_SYMBOLS = 10;
+
+	static bool IsLonger(const std::pair<std::string, FCM::U_Int64>& a,
+		const std::pair<std::string, FCM::U_Int64>& b)
+	{
+		return a.second > b.second;
+	}
+
+	Profiler& Profiler::GetInstance()
+	{
+		static Profiler instance;
+		return instance;
+	}
+
+	Profiler::Profiler()
+		: m_enabled(false)
+	{
+	}
+
+	void Profiler::Start(bool enabled)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		m_events.clear();
+		m_threads.clear();
+		m_threads[std::this_thread::get_id()] = 0;
+		m_startTime = std::chrono::steady_clock::now();
+		m_enabled = enabled;
+	}
+
+	bool Profiler::IsEnabled() const
+	{
+		return m_enabled;
+	}
+
+	FCM::U_Int64 Profiler::Now() const
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - m_startTime).count();
+	}
+
+	void Profiler::Record(const char* name, const std::string& symbol, FCM::U_Int64 start, FCM::U_Int64 duration)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (!m_enabled)
+		{
+			return;
+		}
+
+		std::thread::id id = std::this_thread::get_id();
+		std::map<std::thread::id, FCM::U_Int32>::iterator it = m_threads.find(id);
+		if (it == m_threads.end())
+		{
+			it = m_threads.insert(std::make_pair(id, (FCM::U_Int32)m_threads.size())).first;
+		}
+
+		Event event;
+		event.name = name;
+		event.symbol = symbol;
+		event.start = start;
+		event.duration = duration;
+		event.thread = it->second;
+		m_events.push_back(event);
+	}
+
+	FCM::Result Profiler::Finish(const std::string& traceFile, FCM::PIFCMCallback pCallback)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (!m_enabled)
+		{
+			return FCM_SUCCESS;
+		}
+		m_enabled = false;
+
+		JSONNode events(JSON_ARRAY);
+		events.set_name("traceEvents");
+
+		std::map<std::string, Total> phases;
+		std::map<std::string, Total> symbols;
+
+		for (std::vector<Event>::iterator it = m_events.begin(); it != m_events.end(); it++)
+		{
+			// Complete events, times in microseconds
+			JSONNode event(JSON_NODE);
+			event.push_back(JSONNode("name", it->name));
+			event.push_back(JSONNode("cat", "publish"));
+			event.push_back(JSONNode("ph", "X"));
+			event.push_back(JSONNode("ts", (double)it->start));
+			event.push_back(JSONNode("dur", (double)it->duration));
+			event.push_back(JSONNode("pid", 1));
+			event.push_back(JSONNode("tid", (int)it->thread));
+
+			if (!it->symbol.empty())
+			{
+				JSONNode args(JSON_NODE);
+				args.set_name("args");
+				args.push_back(JSONNode("symbol", it->symbol));
+				event.push_back(args);
+
+				Total& symbol = symbols[it->symbol];
+				symbol.duration += it->duration;
+				symbol.count++;
+			}
+			events.push_back(event);
+
+			Total& phase = phases[it->name];
+			phase.duration += it->duration;
+			phase.count++;
+		}
+
+		// Name the threads, thread 0 started the publish
+		for (FCM::U_Int32 i = 0; i < m_threads.size(); i++)
+		{
+			JSONNode args(JSON_NODE);
+			args.set_name("args");
+			args.push_back(JSONNode("name", i == 0 ? "Publish" : "Data writer " + Utils::ToString(i)));
+
+			JSONNode event(JSON_NODE);
+			event.push_back(JSONNode("name", "thread_name"));
+			event.push_back(JSONNode("ph", "M"));
+			event.push_back(JSONNode("pid", 1));
+			event.push_back(JSONNode("tid", (int)i));
+			event.push_back(args);
+			events.push_back(event);
+		}
+
+		JSONNode root(JSON_NODE);
+		root.push_back(events);
+		root.push_back(JSONNode("displayTimeUnit", "ms"));
+
+		std::fstream file;
+		Utils::OpenFStream(traceFile, file,
+			std::ios_base::trunc | std::ios_base::out | std::ios_base::binary,
+			pCallback);
+		if (!file.is_open())
+		{
+			return FCM_GENERAL_ERROR;
+		}
+
+		file << root.write();
+		file.close();
+
+		// Phases nest, each time includes the phases inside it
+		Utils::Trace(pCallback, "Publish profile written to %s\n", traceFile.c_str());
+		LogTotals(phases, "Phases", (FCM::U_Int32)phases.size(), pCallback);
+		LogTotals(symbols, "Slowest symbols", MAX_LOGGED_SYMBOLS, pCallback);
+
+		return FCM_SUCCESS;
+	}
+
+	void Profiler::LogTotals(const std::map<std::string, Total>& totals, const char* title,
+		FCM::U_Int32 maxCount, FCM::PIFCMCallback pCallback)
+	{
+		if (totals.empty())
+		{
+			return;
+		}
+
+		std::vector<std::pair<std::string, FCM::U_Int64> > sorted;
+		for (std::map<std::string, Total>::const_iterator it = totals.begin(); it != totals.end(); it++)
+		{
+			sorted.push_back(std::make_pair(it->first, it->second.duration));
+		}
+		std::stable_sort(sorted.begin(), sorted.end(), IsLonger);
+
+		Utils::Trace(pCallback, "%s:\n", title);
+		for (FCM::U_Int32 i = 0; i < sorted.size() && i < maxCount; i++)
+		{
+			const Total& total = totals.find(sorted[i].first)->second;
+			Utils::Trace(pCallback, " -> %s : %.1f ms (%u)\n",
+				sorted[i].first.c_str(), total.duration / 1000.0, total.count);
+		}
+	}
+
+	ProfileScope::ProfileScope(const char* name)
+		: m_name(name),
+		m_start(0),
+		m_enabled(Profiler::GetInstance().IsEnabled())
+	{
+		if (m_enabled)
+		{
+			m_start = Profiler::GetInstance().Now();
+		}
+	}
+
+	ProfileScope::ProfileScope(const char* name, const std::string& symbol)
+		: m_name(name),
+		m_start(0),
+		m_enabled(Profiler::GetInstance().IsEnabled())
+	{
+		if (m_enabled)
+		{
+			m_symbol = symbol;
+			m_start = Profiler::GetInstance().Now();
+		}
+	}
+
+	ProfileScope::~ProfileScope()
+	{
+		if (m_enabled)
+		{
+			Profiler& profiler = Profiler::GetInstance();
+			profiler.Record(m_name, m_symbol, m_start, profiler.Now() - m_start);
+		}
+	}
+};
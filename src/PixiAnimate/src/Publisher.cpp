@@ -66,6 +66,8 @@
 #include "Utils/IRadialColorGradient.h"
 
 #include "OutputWriter.h"
+#include "PreviewServer.h"
+#include "Profiler.h"
 
 #include "Exporter/Service/IResourcePalette.h"
 #include "Exporter/Service/ITimelineBuilder2.h"
@@ -73,6 +75,7 @@
 
 #include "Exporter/Service/ISWFExportService.h"
 #include <algorithm>
+#include <cmath>
 #include "PluginConfiguration.h"
 
 namespace PixiJS
@@ -186,7 +189,7 @@ namespace PixiJS
 
 #ifdef _WINDOWS
 
-		if (Utils::RunElectron("--version") != 0)
+		if (Utils::RunElectron("--version", ELECTRON_CHECK_TIMEOUT, NULL) != 0)
 		{
 			Utils::Trace(GetCallback(), "ERROR: Electron is required to be installed in your global NPM package repository. Install by running the following from a commandline:\n\n\tnpm install electron -g");
 			return FCM_GENERAL_ERROR;
@@ -218,12 +221,27 @@ namespace PixiJS
 		bool images(true);
 		bool sounds(true);
 		bool compactShapes(true);
+		bool packShapes(false);
+		bool instanceShapes(false);
+		std::string pathPrecision;
+		std::string matrixPrecision;
+		std::string colorPrecision;
+		std::string alphaPrecision;
+		double shapeGrid;
 		bool compressJS(true);
 		bool loopTimeline(true);
+		bool streamData(false);
+		bool compilerServer(false);
+		bool assetCache(false);
+		bool browserPreview(false);
+		bool profilePublish(false);
+		bool sizeReport(false);
+		bool tweenMoves(false);
 		bool previewNeeded(false);
 		bool spritesheets(true);
 		int spritesheetSize;
 		double spritesheetScale;
+		int seekInterval;
 
 		std::string htmlPath;
 		std::string stageName;
@@ -245,8 +263,17 @@ namespace PixiJS
 		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_IMAGES, images);
 		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_SOUNDS, sounds);
 		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_COMPACT_SHAPES, compactShapes);
+		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_PACK_SHAPES, packShapes);
+		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_INSTANCE_SHAPES, instanceShapes);
 		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_COMPRESS_JS, compressJS);
 		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_LOOP_TIMELINE, loopTimeline);
+		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_STREAM_DATA, streamData);
+		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_COMPILER_SERVER, compilerServer);
+		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_ASSET_CACHE, assetCache);
+		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_BROWSER_PREVIEW, browserPreview);
+		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_PROFILE_PUBLISH, profilePublish);
+		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_SIZE_REPORT, sizeReport);
+		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_TWEEN_MOVES, tweenMoves);
 		Utils::ReadStringToBool(publishSettings, (FCM::StringRep8)DICT_SPRITESHEETS, spritesheets);
 		Utils::ReadString(publishSettings, (FCM::StringRep8)DICT_VERSION, outputVersion);
 		Utils::ReadString(publishSettings, (FCM::StringRep8)DICT_OUTPUT_FORMAT, outputFormat);
@@ -257,7 +284,25 @@ namespace PixiJS
 		Utils::ReadString(publishSettings, (FCM::StringRep8)DICT_NAMESPACE, nameSpace);
 		Utils::ReadString(publishSettings, (FCM::StringRep8)DICT_STAGE_NAME, stageName);
 		Utils::ReadStringToInt(publishSettings, (FCM::StringRep8)DICT_SPRITESHEET_SIZE, spritesheetSize);
+		Utils::ReadStringToInt(publishSettings, (FCM::StringRep8)DICT_SEEK_INTERVAL, seekInterval);
 		Utils::ReadStringToFloat(publishSettings, (FCM::StringRep8)DICT_SPRITESHEET_SCALE, spritesheetScale);
+		Utils::ReadStringToFloat(publishSettings, (FCM::StringRep8)DICT_SHAPE_GRID, shapeGrid);
+		Utils::ReadString(publishSettings, (FCM::StringRep8)DICT_PATH_PRECISION, pathPrecision);
+		Utils::ReadString(publishSettings, (FCM::StringRep8)DICT_MATRIX_PRECISION, matrixPrecision);
+		Utils::ReadString(publishSettings, (FCM::StringRep8)DICT_COLOR_PRECISION, colorPrecision);
+		Utils::ReadString(publishSettings, (FCM::StringRep8)DICT_ALPHA_PRECISION, alphaPrecision);
+
+		// The compiler rounds path coordinates to 2 decimals,
+		// any more in the data file are never used
+		Utils::SetPrecision(PATH_PRECISION, pathPrecision.empty() ? 2 : atoi(pathPrecision.c_str()));
+		Utils::SetPrecision(MATRIX_PRECISION, matrixPrecision.empty() ? MAX_PRECISION : atoi(matrixPrecision.c_str()));
+		Utils::SetPrecision(COLOR_PRECISION, colorPrecision.empty() ? MAX_PRECISION : atoi(colorPrecision.c_str()));
+		Utils::SetPrecision(ALPHA_PRECISION, alphaPrecision.empty() ? MAX_PRECISION : atoi(alphaPrecision.c_str()));
+
+		if (shapeGrid < 0.0)
+		{
+			shapeGrid = 0.0;
+		}
 
 		if (spritesheetScale == 0.0)
 		{
@@ -269,6 +314,24 @@ namespace PixiJS
 			spritesheetSize = 1024;
 		}
 
+		if (seekInterval < 0)
+		{
+			seekInterval = 0;
+		}
+
+		// Cached bitmaps are only reused while the saved document is unchanged
+		std::string documentPath;
+		if (assetCache)
+		{
+			FCM::StringRep16 pDocumentPath = NULL;
+			res = flaDocument->GetPath(&pDocumentPath);
+			if (FCM_SUCCESS_CODE(res) && pDocumentPath)
+			{
+				documentPath = Utils::ToString(pDocumentPath, GetCallback());
+				pCalloc->Free(pDocumentPath);
+			}
+		}
+
 		// Filter the stagename
 		Utils::GetJavaScriptName(stageName, stageName);
 
@@ -280,8 +343,21 @@ namespace PixiJS
 		Utils::Trace(GetCallback(), " -> Namespace : %s\n", nameSpace.c_str());
 		Utils::Trace(GetCallback(), " -> Stage Name : %s\n", stageName.c_str());
 		Utils::Trace(GetCallback(), " -> Compact Shapes : %s\n", Utils::ToString(compactShapes).c_str());
+		Utils::Trace(GetCallback(), " -> Pack Shapes : %s\n", Utils::ToString(packShapes).c_str());
+		Utils::Trace(GetCallback(), " -> Shape Grid : %f\n", shapeGrid);
+		Utils::Trace(GetCallback(), " -> Instance Shapes : %s\n", Utils::ToString(instanceShapes).c_str());
+		Utils::Trace(GetCallback(), " -> Precision (path, matrix, color, alpha) : %s, %s, %s, %s\n",
+			pathPrecision.c_str(), matrixPrecision.c_str(), colorPrecision.c_str(), alphaPrecision.c_str());
 		Utils::Trace(GetCallback(), " -> Compress JS : %s\n", Utils::ToString(compressJS).c_str());
 		Utils::Trace(GetCallback(), " -> Loop Timeline : %s\n", Utils::ToString(loopTimeline).c_str());
+		Utils::Trace(GetCallback(), " -> Stream Data : %s\n", Utils::ToString(streamData).c_str());
+		Utils::Trace(GetCallback(), " -> Compiler Server : %s\n", Utils::ToString(compilerServer).c_str());
+		Utils::Trace(GetCallback(), " -> Asset Cache : %s\n", Utils::ToString(assetCache).c_str());
+		Utils::Trace(GetCallback(), " -> Browser Preview : %s\n", Utils::ToString(browserPreview).c_str());
+		Utils::Trace(GetCallback(), " -> Profile Publish : %s\n", Utils::ToString(profilePublish).c_str());
+		Utils::Trace(GetCallback(), " -> Size Report : %s\n", Utils::ToString(sizeReport).c_str());
+		Utils::Trace(GetCallback(), " -> Seek Interval : %d\n", seekInterval);
+		Utils::Trace(GetCallback(), " -> Tween Moves : %s\n", Utils::ToString(tweenMoves).c_str());
         if (html)
         {
             Utils::Trace(GetCallback(), " -> HTML path : %s\n", htmlPath.c_str());
@@ -309,6 +385,9 @@ namespace PixiJS
 		}
 #endif
 
+		// Phases are timed from here, also stops recording after a failed publish
+		Profiler::GetInstance().Start(profilePublish);
+
 		// Temporary
 		// return FCM_SUCCESS;
 		std::auto_ptr<PixiJS::TweenWriter> tweenWriter(new PixiJS::TweenWriter(GetCallback()));
@@ -329,11 +408,21 @@ namespace PixiJS
 			images,
 			sounds,
 			compactShapes,
+			packShapes,
+			shapeGrid,
 			compressJS,
 			loopTimeline,
 			spritesheets,
 			spritesheetSize,
-			spritesheetScale));
+			spritesheetScale,
+			streamData,
+			compilerServer,
+			assetCache,
+			documentPath,
+			browserPreview,
+			sizeReport,
+			seekInterval,
+			tweenMoves));
 
 		if (outputWriter.get() == NULL)
 		{
@@ -354,12 +443,13 @@ namespace PixiJS
 			return res;
 		}
 
-		(static_cast<TimelineBuilderFactory*>(timelineBuilderFactory.m_Ptr))->Init(
-			outputWriter.get());
-
 		ResourcePalette* pResPalette = static_cast<ResourcePalette*>(m_pResourcePalette.m_Ptr);
 		pResPalette->Clear();
-		pResPalette->Init(outputWriter.get());
+		pResPalette->Init(outputWriter.get(), instanceShapes);
+
+		(static_cast<TimelineBuilderFactory*>(timelineBuilderFactory.m_Ptr))->Init(
+			outputWriter.get(),
+			pResPalette);
 
 		res = flaDocument->GetBackgroundColor(color);
 		ASSERT(FCM_SUCCESS_CODE(res));
@@ -376,7 +466,10 @@ namespace PixiJS
 		framesPerSec = (FCM::U_Int32)fps;
 
 		res = outputWriter->StartDocument(color, stageHeight, stageWidth, framesPerSec);
-		ASSERT(FCM_SUCCESS_CODE(res));
+		if (FCM_FAILURE_CODE(res))
+		{
+			return res;
+		}
 
 		// Export complete document ?
 		if (!timeline)
@@ -434,23 +527,32 @@ namespace PixiJS
 
 				range.max--;
 
-				// Generate frame commands
-				res = m_frameCmdGeneratorService->GenerateFrameCommands(
-					timeline,
-					range,
-					publishSettings,
-					m_pResourcePalette,
-					timelineBuilderFactory,
-					timelineBuilder.m_Ptr);
+				// Generate frame commands, the resource palette is filled meanwhile
+				{
+					ProfileScope scope("Generate frame commands");
+					res = m_frameCmdGeneratorService->GenerateFrameCommands(
+						timeline,
+						range,
+						publishSettings,
+						m_pResourcePalette,
+						timelineBuilderFactory,
+						timelineBuilder.m_Ptr);
+				}
 
 				if (FCM_FAILURE_CODE(res))
 				{
 					return res;
 				}
 
-				((TimelineBuilder*)timelineBuilder.m_Ptr)->Build(0, NULL, &timelineWriter);
+				{
+					ProfileScope scope("Build stage timeline", stageName);
+					((TimelineBuilder*)timelineBuilder.m_Ptr)->Build(0, NULL, &timelineWriter);
+				}
 
-				tweenWriter->ReadTimeline(timeline.m_Ptr, stageName);
+				{
+					ProfileScope scope("Read tweens");
+					tweenWriter->ReadTimeline(timeline.m_Ptr, stageName);
+				}
 			}
 
 			// Export the library items with linkages
@@ -461,10 +563,16 @@ namespace PixiJS
 				return res;
 			}
 
-			ExportLibraryItems(pLibraryItemList, tweenWriter.get());
+			{
+				ProfileScope scope("Export library items");
+				ExportLibraryItems(pLibraryItemList, tweenWriter.get());
+			}
 
 			outputWriter->AddTweens(tweenWriter->GetRoot());
-			res = outputWriter->EndDocument();
+			{
+				ProfileScope scope("End document");
+				res = outputWriter->EndDocument();
+			}
 			ASSERT(FCM_SUCCESS_CODE(res));
 		}
 		else
@@ -474,31 +582,44 @@ namespace PixiJS
 			ITimelineWriter* timelineWriter;
 
 			// Generate frame commands
-			res = m_frameCmdGeneratorService->GenerateFrameCommands(
-				timeline,
-				*pFrameRange,
-				publishSettings,
-				m_pResourcePalette,
-				timelineBuilderFactory,
-				timelineBuilder.m_Ptr);
+			{
+				ProfileScope scope("Generate frame commands");
+				res = m_frameCmdGeneratorService->GenerateFrameCommands(
+					timeline,
+					*pFrameRange,
+					publishSettings,
+					m_pResourcePalette,
+					timelineBuilderFactory,
+					timelineBuilder.m_Ptr);
+			}
 
 			if (FCM_FAILURE_CODE(res))
 			{
 				return res;
 			}
 
-			((TimelineBuilder*)timelineBuilder.m_Ptr)->Build(0, NULL, &timelineWriter);
+			{
+				ProfileScope scope("Build stage timeline", stageName);
+				((TimelineBuilder*)timelineBuilder.m_Ptr)->Build(0, NULL, &timelineWriter);
+			}
 
-			res = outputWriter->EndDocument();
+			{
+				ProfileScope scope("End document");
+				res = outputWriter->EndDocument();
+			}
 			ASSERT(FCM_SUCCESS_CODE(res));
 		}
 
-		// Stop preview
-		outputWriter->StopPreview();
+		// An open preview is reloaded when the preview is shown again
+		if (!previewNeeded)
+		{
+			outputWriter->StopPreview();
+		}
 
 		if (libs)
 		{
 			// We are now going to copy the runtime from the zxp package to the output folder.
+			ProfileScope scope("Copy runtime");
 			CopyRuntime(basePath + libsPath, compressJS, outputVersion);
 		}
 
@@ -510,9 +631,28 @@ namespace PixiJS
 			}
 			else
 			{
+				ProfileScope scope("Start preview");
 				outputWriter->StartPreview(GetCallback());
 			}
 		}
+#ifdef USE_HTTP_SERVER
+		else
+		{
+			// Browsers open on this output show the new publish
+			PreviewServer::GetInstance().Reload(basePath);
+		}
+#endif
+
+		if (profilePublish)
+		{
+			// The whole publish, from reading the settings
+			Profiler& profiler = Profiler::GetInstance();
+			profiler.Record("Publish", "", 0, profiler.Now());
+
+			std::string traceName;
+			Utils::GetFileNameWithoutExtension(outputFile, traceName);
+			profiler.Finish(basePath + traceName + ".trace.json", GetCallback());
+		}
 
 #endif
 		return FCM_SUCCESS;
@@ -527,6 +667,14 @@ namespace PixiJS
 
 			pResPalette->Clear();
 		}
+
+		// Export every bitmap again on the next publish
+		std::string cacheDir;
+		if (FCM_SUCCESS_CODE(Utils::GetCacheDir(GetCallback(), cacheDir)))
+		{
+			Utils::Remove(cacheDir, GetCallback());
+		}
+
 		return FCM_SUCCESS;
 	}
 
@@ -773,9 +921,6 @@ namespace PixiJS
 		// Get the source folder
 		Utils::GetExtensionPath(sourceFolder, GetCallback());
 
-		// First let us remove the existing runtime folder (if any)
-		Utils::Remove(outputFolder, GetCallback());
-
 		// Copy the runtime folder
 		if (!compressJS)
 		{
@@ -799,7 +944,15 @@ namespace PixiJS
 				runtimeFolder = RUNTIME_ROOT_FOLDER_NAME;
 			}
 		}
-		res = Utils::CopyDir(sourceFolder + runtimeFolder, outputFolder, GetCallback());
+
+		// Only the files that changed since the last publish are copied,
+		// and files left over from another runtime version are deleted
+		FCM::U_Int32 copiedCount = 0;
+		res = Utils::SyncDir(sourceFolder + runtimeFolder, outputFolder, GetCallback(), copiedCount);
+
+#ifdef _DEBUG
+		Utils::Trace(GetCallback(), "Copied %d runtime files\n", copiedCount);
+#endif
 
 		return res;
 	}
@@ -825,6 +978,12 @@ namespace PixiJS
 
 		TimelineBuilder* timeline = static_cast<TimelineBuilder*>(timelineBuilder);
 
+		// Shapes are only compared within a timeline, release the ones
+		// it held rather than keep every shape until the publish ends
+		m_shapeSources.clear();
+
+		ProfileScope scope("Add symbol",
+			pName != NULL ? m_resourceNames.back() : "Symbol " + Utils::ToString(resourceId));
 		return timeline->Build(resourceId, pName, &timelineWriter);
 	}
 
@@ -839,7 +998,16 @@ namespace PixiJS
 
 		LOG(("[DefineShape] ResId: %d\n", resourceId));
 
+		ProfileScope scope("Add shape");
+
 		m_resourceList.push_back(resourceId);
+
+		// Same geometry as a shape already exported, place that one instead
+		if (pShape && m_instanceShapes && FindSimilarShape(resourceId, pShape))
+		{
+			return FCM_SUCCESS;
+		}
+
 		m_outputWriter->StartDefineShape();
 
 		if (pShape)
@@ -893,7 +1061,10 @@ namespace PixiJS
 		AutoPtr<DOM::MediaInfo::ISoundInfo> pSoundInfo = pUnknown;
 		ASSERT(pSoundInfo);
 
-		m_outputWriter->DefineSound(resourceId, libName, pMediaItem);
+		{
+			ProfileScope scope("Add sound", libName);
+			m_outputWriter->DefineSound(resourceId, libName, pMediaItem);
+		}
 
 		// Free the name
 		FCM::AutoPtr<FCM::IFCMUnknown> pUnkCalloc;
@@ -941,7 +1112,10 @@ namespace PixiJS
 		ASSERT(FCM_SUCCESS_CODE(res));
 
 		// Dump the definition of a bitmap
-		res = m_outputWriter->DefineBitmap(resourceId, height, width, libItemName, pMediaItem);
+		{
+			ProfileScope scope("Add bitmap", libItemName);
+			res = m_outputWriter->DefineBitmap(resourceId, height, width, libItemName, pMediaItem);
+		}
 
 		// Free the name
 		FCM::AutoPtr<FCM::IFCMUnknown> pUnkCalloc;
@@ -968,6 +1142,8 @@ namespace PixiJS
 
 		ASSERT(pClassicText);
 
+		ProfileScope scope("Add text");
+
 		pTextItem = pClassicText;
 
 		res = pTextItem->GetText(&textDisplay);
@@ -1093,6 +1269,7 @@ namespace PixiJS
 	ResourcePalette::ResourcePalette()
 	{
 		m_outputWriter = NULL;
+		m_instanceShapes = false;
 	}
 
 
@@ -1101,14 +1278,32 @@ namespace PixiJS
 	}
 
 
-	void ResourcePalette::Init(IOutputWriter* outputWriter)
+	void ResourcePalette::Init(IOutputWriter* outputWriter, bool instanceShapes)
 	{
 		m_outputWriter = outputWriter;
+		m_instanceShapes = instanceShapes;
 	}
 
 	void ResourcePalette::Clear()
 	{
 		m_resourceList.clear();
+		m_shapeSources.clear();
+		m_shapeInstances.clear();
+	}
+
+	bool ResourcePalette::GetShapeInstance(
+		FCM::U_Int32 resourceId,
+		FCM::U_Int32& sourceId,
+		DOM::Utils::MATRIX2D& mapAtoB) const
+	{
+		std::map<FCM::U_Int32, SHAPE_INSTANCE>::const_iterator it = m_shapeInstances.find(resourceId);
+		if (it == m_shapeInstances.end())
+		{
+			return false;
+		}
+		sourceId = it->second.sourceId;
+		mapAtoB = it->second.mapAtoB;
+		return true;
 	}
 
 	FCM::Result ResourcePalette::HasResource(
@@ -1427,6 +1622,196 @@ namespace PixiJS
 	}
 
 
+	// Whether a matrix only rotates, flips and moves
+	static bool IsUnitScale(const DOM::Utils::MATRIX2D& matrix)
+	{
+		const double tolerance = 0.001;
+
+		return fabs(matrix.a * matrix.a + matrix.b * matrix.b - 1) < tolerance &&
+			fabs(matrix.c * matrix.c + matrix.d * matrix.d - 1) < tolerance &&
+			fabs(matrix.a * matrix.c + matrix.b * matrix.d) < tolerance;
+	}
+
+
+	// Count the fills, strokes and edges of a shape, and the shape of its bounds
+	FCM::Result ResourcePalette::GetShapeSignature(
+		DOM::FrameElement::PIShape pShape,
+		SHAPE_SIGNATURE& signature)
+	{
+		FCM::Result res;
+		FCM::FCMListPtr pFilledRegionList;
+		FCM::FCMListPtr pStrokeGroupList;
+		FCM::AutoPtr<FCM::IFCMUnknown> pUnkSRVReg;
+		FCM::U_Int32 edgeCount;
+		DOM::Utils::RECT bounds;
+
+		signature.fillCount = 0;
+		signature.strokeCount = 0;
+		signature.edgeCount = 0;
+		signature.aspect = 0;
+
+		GetCallback()->GetService(DOM::FLA_REGION_GENERATOR_SERVICE, pUnkSRVReg.m_Ptr);
+		AutoPtr<DOM::Service::Shape::IRegionGeneratorService> pIRegionGeneratorService(pUnkSRVReg);
+		ASSERT(pIRegionGeneratorService);
+
+		// Fills, with the edges of their boundaries and holes
+		res = pIRegionGeneratorService->GetFilledRegions(pShape, pFilledRegionList.m_Ptr);
+		ASSERT(FCM_SUCCESS_CODE(res));
+
+		pFilledRegionList->Count(signature.fillCount);
+
+		for (FCM::U_Int32 j = 0; j < signature.fillCount; j++)
+		{
+			FCM::AutoPtr<DOM::Service::Shape::IFilledRegion> pFilledRegion = pFilledRegionList[j];
+			FCM::AutoPtr<DOM::Service::Shape::IPath> pPath;
+			FCMListPtr pHoleList;
+			FCM::U_Int32 holeCount;
+
+			res = pFilledRegion->GetBoundary(pPath.m_Ptr);
+			ASSERT(FCM_SUCCESS_CODE(res));
+
+			GetEdgeCount(pPath, edgeCount);
+			signature.edgeCount += edgeCount;
+
+			res = pFilledRegion->GetHoles(pHoleList.m_Ptr);
+			ASSERT(FCM_SUCCESS_CODE(res));
+
+			pHoleList->Count(holeCount);
+
+			for (FCM::U_Int32 k = 0; k < holeCount; k++)
+			{
+				FCM::AutoPtr<DOM::Service::Shape::IPath> pHole = pHoleList[k];
+
+				GetEdgeCount(pHole, edgeCount);
+				signature.edgeCount += edgeCount;
+			}
+		}
+
+		// Strokes, with the edges of their paths
+		res = pIRegionGeneratorService->GetStrokeGroups(pShape, pStrokeGroupList.m_Ptr);
+		ASSERT(FCM_SUCCESS_CODE(res));
+
+		pStrokeGroupList->Count(signature.strokeCount);
+
+		for (FCM::U_Int32 j = 0; j < signature.strokeCount; j++)
+		{
+			AutoPtr<DOM::Service::Shape::IStrokeGroup> pStrokeGroup = pStrokeGroupList[j];
+			FCMListPtr pPathList;
+			FCM::U_Int32 pathCount;
+
+			res = pStrokeGroup->GetPaths(pPathList.m_Ptr);
+			ASSERT(FCM_SUCCESS_CODE(res));
+
+			pPathList->Count(pathCount);
+
+			for (FCM::U_Int32 k = 0; k < pathCount; k++)
+			{
+				FCM::AutoPtr<DOM::Service::Shape::IPath> pPath = pPathList[k];
+
+				GetEdgeCount(pPath, edgeCount);
+				signature.edgeCount += edgeCount;
+			}
+		}
+
+		// Short side over long side so the signature doesn't
+		// change when a shape is turned on its side
+		FCM::AutoPtr<DOM::FrameElement::IFrameDisplayElement> pDisplayElement = pShape;
+		if (pDisplayElement && FCM_SUCCESS_CODE(pDisplayElement->GetObjectSpaceBounds(bounds)))
+		{
+			double width = fabs(bounds.bottomRight.x - bounds.topLeft.x);
+			double height = fabs(bounds.bottomRight.y - bounds.topLeft.y);
+			double longSide = width > height ? width : height;
+			double shortSide = width > height ? height : width;
+
+			if (longSide > 0)
+			{
+				signature.aspect = (FCM::U_Int32)floor(shortSide / longSide * 32 + 0.5);
+			}
+		}
+
+		return FCM_SUCCESS;
+	}
+
+
+	// Number of edges along a path
+	FCM::Result ResourcePalette::GetEdgeCount(
+		DOM::Service::Shape::PIPath pPath,
+		FCM::U_Int32& edgeCount)
+	{
+		FCM::Result res;
+		FCM::FCMListPtr pEdgeList;
+
+		edgeCount = 0;
+
+		res = pPath->GetEdges(pEdgeList.m_Ptr);
+		if (FCM_FAILURE_CODE(res))
+		{
+			return res;
+		}
+
+		return pEdgeList->Count(edgeCount);
+	}
+
+
+	// Map a shape onto an earlier one with the same geometry, or keep it
+	// as a source for later shapes
+	bool ResourcePalette::FindSimilarShape(
+		FCM::U_Int32 resourceId,
+		DOM::FrameElement::PIShape pShape)
+	{
+		FCM::Result res;
+		FCM::AutoPtr<FCM::IFCMUnknown> pUnkSRVReg;
+		SHAPE_SIGNATURE signature;
+
+		res = GetShapeSignature(pShape, signature);
+		if (FCM_FAILURE_CODE(res))
+		{
+			return false;
+		}
+
+		GetCallback()->GetService(DOM::FLA_SHAPE_SERVICE, pUnkSRVReg.m_Ptr);
+		AutoPtr<DOM::Service::Shape::IShapeService> pIShapeService(pUnkSRVReg);
+		ASSERT(pIShapeService);
+
+		// Only shapes with the same signature are worth comparing
+		std::vector<SHAPE_SOURCE>& sources = m_shapeSources[signature];
+
+		for (size_t i = 0; i < sources.size(); i++)
+		{
+			FCM::Boolean similar = false;
+			SHAPE_INSTANCE instance;
+
+			res = pIShapeService->TestShapeSimilarity(
+				sources[i].pShape,
+				pShape,
+				similar,
+				instance.mapAtoB);
+
+			if (FCM_SUCCESS_CODE(res) && similar)
+			{
+				// A scaled copy would scale its stroke widths too
+				if (signature.strokeCount > 0 && !IsUnitScale(instance.mapAtoB))
+				{
+					continue;
+				}
+
+				LOG(("[InstanceShape] ResId: %d SourceId: %d\n", resourceId, sources[i].resourceId));
+
+				instance.sourceId = sources[i].resourceId;
+				m_shapeInstances[resourceId] = instance;
+				return true;
+			}
+		}
+
+		SHAPE_SOURCE source;
+		source.resourceId = resourceId;
+		source.pShape = pShape;
+		sources.push_back(source);
+
+		return false;
+	}
+
+
 	// Convert strokes to fills
 	FCM::Result ResourcePalette::ConvertStrokeToFill(
 		DOM::FrameElement::PIShape pShape,
@@ -1860,6 +2245,21 @@ namespace PixiJS
 		LOG(("[AddShape] ObjId: %d ResId: %d PlaceAfter: %d\n",
 			objectId, pShapeInfo->resourceId, pShapeInfo->placeAfterObjectId));
 
+		FCM::U_Int32 sourceId;
+		DOM::Utils::MATRIX2D mapAtoB;
+
+		// The shape was exported as a copy of another, place that shape
+		if (m_resourcePalette->GetShapeInstance(pShapeInfo->resourceId, sourceId, mapAtoB))
+		{
+			return m_timelineWriter->PlaceObject(
+				sourceId,
+				objectId,
+				pShapeInfo->placeAfterObjectId,
+				&pShapeInfo->matrix,
+				NULL,
+				&mapAtoB);
+		}
+
 		res = m_timelineWriter->PlaceObject(
 			pShapeInfo->resourceId,
 			objectId,
@@ -2185,6 +2585,7 @@ namespace PixiJS
 
 	TimelineBuilder::TimelineBuilder() :
 		m_outputWriter(NULL),
+		m_resourcePalette(NULL),
 		m_frameIndex(0)
 	{
 		//LOG(("[CreateTimeline]\n"));
@@ -2194,9 +2595,10 @@ namespace PixiJS
 	{
 	}
 
-	void TimelineBuilder::Init(IOutputWriter* outputWriter)
+	void TimelineBuilder::Init(IOutputWriter* outputWriter, ResourcePalette* resourcePalette)
 	{
 		m_outputWriter = outputWriter;
+		m_resourcePalette = resourcePalette;
 
 		m_outputWriter->StartDefineTimeline();
 
@@ -2206,7 +2608,9 @@ namespace PixiJS
 
 	/* ----------------------------------------------------- TimelineBuilderFactory */
 
-	TimelineBuilderFactory::TimelineBuilderFactory()
+	TimelineBuilderFactory::TimelineBuilderFactory() :
+		m_outputWriter(NULL),
+		m_resourcePalette(NULL)
 	{
 	}
 
@@ -2220,14 +2624,15 @@ namespace PixiJS
 
 		TimelineBuilder* timeline = static_cast<TimelineBuilder*>(timelineBuilder);
 
-		timeline->Init(m_outputWriter);
+		timeline->Init(m_outputWriter, m_resourcePalette);
 
 		return res;
 	}
 
-	void TimelineBuilderFactory::Init(IOutputWriter* outputWriter)
+	void TimelineBuilderFactory::Init(IOutputWriter* outputWriter, ResourcePalette* resourcePalette)
 	{
 		m_outputWriter = outputWriter;
+		m_resourcePalette = resourcePalette;
 	}
 
 	FCM::Result RegisterPublisher(PIFCMDictionary pPlugins, FCM::FCMCLSID docId)
@@ -0,0 +1,273 @@
+//
+//  SizeReport.cpp
+//  PixiAnimate.mp
+//
+//  Adds up what each asset costs in the data file, bytes, path segments,
+//  frame commands and export time, and writes it out biggest first.
+//
+
+#include "SizeReport.h"
+#include "libjson.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace PixiJS
+{
+	// Kinds of entries, must match DataWriter::Section
+	static const char* sectionTypes[DataWriter::SECTION_COUNT] =
+	{
+		"shape",
+		"bitmap",
+		"sound",
+		"text",
+		"timeline",
+		"tweens",
+		"fill styles",
+		"stroke styles",
+		"gradients"
+	};
+
+	SizeReport::SizeReport(FCM::PIFCMCallback pCallback)
+		: m_pCallback(pCallback)
+	{
+	}
+
+	FCM::U_Int64 SizeReport::Now()
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	SizeReport::Entry& SizeReport::GetEntry(DataWriter::Section section, FCM::U_Int32 assetId)
+	{
+		EntryMap::iterator it = m_entries.find(Key(section, assetId));
+		if (it != m_entries.end())
+		{
+			return it->second;
+		}
+
+		Entry entry;
+		entry.bytes = 0;
+		entry.fileBytes = 0;
+		entry.time = 0;
+		entry.count = 0;
+		entry.pathSegments = 0;
+		entry.frames = 0;
+		return m_entries.insert(std::make_pair(Key(section, assetId), entry)).first->second;
+	}
+
+	void SizeReport::SetName(DataWriter::Section section, FCM::U_Int32 assetId, const std::string& name)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		GetEntry(section, assetId).name = name;
+	}
+
+	void SizeReport::AddBytes(DataWriter::Section section, FCM::U_Int32 assetId, FCM::U_Int64 bytes)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		Entry& entry = GetEntry(section, assetId);
+		entry.bytes += bytes;
+		entry.count++;
+	}
+
+	void SizeReport::AddTime(DataWriter::Section section, FCM::U_Int32 assetId, FCM::U_Int64 microseconds)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		GetEntry(section, assetId).time += microseconds;
+	}
+
+	void SizeReport::AddPathSegments(FCM::U_Int32 shapeId, FCM::U_Int32 count)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		GetEntry(DataWriter::SHAPES, shapeId).pathSegments += count;
+	}
+
+	void SizeReport::AddFile(DataWriter::Section section, FCM::U_Int32 assetId, const std::string& path)
+	{
+		std::fstream file;
+		Utils::OpenFStream(path, file, std::ios_base::in | std::ios_base::binary | std::ios_base::ate, m_pCallback);
+		if (!file.is_open())
+		{
+			return;
+		}
+
+		FCM::U_Int64 size = (FCM::U_Int64)file.tellg();
+		file.close();
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		GetEntry(section, assetId).fileBytes += size;
+	}
+
+	void SizeReport::AddCommands(FCM::U_Int32 timelineId, const JSONNode& timeline)
+	{
+		std::map<std::string, FCM::U_Int32> commands;
+		FCM::U_Int32 frames = 0;
+
+		JSONNode::const_iterator frameArray = timeline.find("frames");
+		if (frameArray != timeline.end())
+		{
+			for (JSONNode::const_iterator frame = frameArray->begin(); frame != frameArray->end(); frame++)
+			{
+				JSONNode::const_iterator commandArray = frame->find("commands");
+				if (commandArray == frame->end())
+				{
+					continue;
+				}
+
+				for (JSONNode::const_iterator command = commandArray->begin(); command != commandArray->end(); command++)
+				{
+					JSONNode::const_iterator type = command->find("type");
+					if (type != command->end())
+					{
+						commands[type->as_string()]++;
+					}
+				}
+			}
+		}
+
+		JSONNode::const_iterator totalFrames = timeline.find("totalFrames");
+		if (totalFrames != timeline.end())
+		{
+			frames = (FCM::U_Int32)totalFrames->as_int();
+		}
+
+		// Locked only to store, the workers report meanwhile
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		Entry& entry = GetEntry(DataWriter::TIMELINES, timelineId);
+		entry.frames = frames;
+		entry.commands.swap(commands);
+	}
+
+	bool SizeReport::IsCostlier(EntryMap::const_iterator a, EntryMap::const_iterator b)
+	{
+		FCM::U_Int64 aBytes = a->second.bytes + a->second.fileBytes;
+		FCM::U_Int64 bBytes = b->second.bytes + b->second.fileBytes;
+		if (aBytes != bBytes)
+		{
+			return aBytes > bBytes;
+		}
+		return a->second.time > b->second.time;
+	}
+
+	FCM::Result SizeReport::Save(const std::string& path)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		std::vector<EntryMap::const_iterator> sorted;
+		FCM::U_Int64 totalBytes = 0;
+		FCM::U_Int64 totalFileBytes = 0;
+
+		for (EntryMap::const_iterator it = m_entries.begin(); it != m_entries.end(); it++)
+		{
+			sorted.push_back(it);
+			totalBytes += it->second.bytes;
+			totalFileBytes += it->second.fileBytes;
+		}
+		std::stable_sort(sorted.begin(), sorted.end(), IsCostlier);
+
+		JSONNode assets(JSON_ARRAY);
+		assets.set_name("assets");
+
+		std::string table;
+		char line[512];
+
+		// Share of the data file and the exported files together
+		snprintf(line, sizeof(line), "%-32s %-14s %10s %10s %6s %9s %9s %10s  %s\n",
+			"Asset", "Type", "Bytes", "File bytes", "Share", "Segments", "Commands", "Time (ms)", "Commands by type");
+		table += line;
+
+		for (size_t i = 0; i < sorted.size(); i++)
+		{
+			const Key& key = sorted[i]->first;
+			const Entry& entry = sorted[i]->second;
+
+			std::string name = entry.name;
+			if (name.empty())
+			{
+				// Shared entries are named after their section
+				name = key.second != 0 ? std::string(sectionTypes[key.first]) + " " + Utils::ToString(key.second)
+					: std::string(sectionTypes[key.first]);
+			}
+
+			FCM::U_Int32 commandCount = 0;
+			std::string byType;
+			JSONNode commands(JSON_NODE);
+			commands.set_name("commands");
+			for (std::map<std::string, FCM::U_Int32>::const_iterator it = entry.commands.begin(); it != entry.commands.end(); it++)
+			{
+				commandCount += it->second;
+				commands.push_back(JSONNode(it->first, it->second));
+				byType += (byType.empty() ? "" : ", ") + it->first + " " + Utils::ToString(it->second);
+			}
+
+			JSONNode asset(JSON_NODE);
+			asset.push_back(JSONNode("name", name));
+			asset.push_back(JSONNode("type", sectionTypes[key.first]));
+			if (key.second != 0 || key.first == DataWriter::TIMELINES)
+			{
+				asset.push_back(JSONNode("assetId", key.second));
+			}
+			asset.push_back(JSONNode("bytes", (double)entry.bytes));
+			if (key.first == DataWriter::BITMAPS || key.first == DataWriter::SOUNDS)
+			{
+				asset.push_back(JSONNode("fileBytes", (double)entry.fileBytes));
+			}
+			asset.push_back(JSONNode("entries", entry.count));
+			asset.push_back(JSONNode("time", entry.time / 1000.0));
+			if (key.first == DataWriter::SHAPES)
+			{
+				asset.push_back(JSONNode("pathSegments", entry.pathSegments));
+			}
+			if (key.first == DataWriter::TIMELINES)
+			{
+				asset.push_back(JSONNode("frames", entry.frames));
+				asset.push_back(commands);
+			}
+			assets.push_back(asset);
+
+			FCM::U_Int64 total = totalBytes + totalFileBytes;
+			snprintf(line, sizeof(line), "%-32s %-14s %10llu %10llu %5.1f%% %9u %9u %10.1f  %s\n",
+				name.c_str(), sectionTypes[key.first], (unsigned long long)entry.bytes,
+				(unsigned long long)entry.fileBytes,
+				total > 0 ? (entry.bytes + entry.fileBytes) * 100.0 / total : 0.0,
+				entry.pathSegments, commandCount, entry.time / 1000.0, byType.c_str());
+			table += line;
+		}
+
+		JSONNode root(JSON_NODE);
+		root.push_back(JSONNode("totalBytes", (double)totalBytes));
+		root.push_back(JSONNode("totalFileBytes", (double)totalFileBytes));
+		root.push_back(assets);
+
+		std::fstream file;
+		Utils::OpenFStream(path + ".json", file,
+			std::ios_base::trunc | std::ios_base::out | std::ios_base::binary,
+			m_pCallback);
+		if (!file.is_open())
+		{
+			return FCM_GENERAL_ERROR;
+		}
+		file << root.write_formatted();
+		file.close();
+
+		Utils::OpenFStream(path + ".txt", file,
+			std::ios_base::trunc | std::ios_base::out | std::ios_base::binary,
+			m_pCallback);
+		if (!file.is_open())
+		{
+			return FCM_GENERAL_ERROR;
+		}
+		file << table;
+		file.close();
+
+		Utils::Trace(m_pCallback, "Size report written to %s.txt\n", path.c_str());
+
+		return FCM_SUCCESS;
+	}
+};
@@ -23,14 +23,28 @@
 #include "GraphicFilter/IGradientGlowFilter.h"
 #include "Utils/ILinearColorGradient.h"
 
+#include <algorithm>
+#include <cmath>
+#include <set>
+
 namespace PixiJS
 {
+	// Frames in a run before its inside Moves become a tween, two Moves
+	// at least are dropped
+	static const FCM::U_Int32 MIN_TWEEN_FRAMES = 4;
+
+	// How far a matrix may stray from the straight line, in pixels for
+	// tx and ty and in scale for a and d
+	static const FCM::Double TWEEN_POSITION_TOLERANCE = 0.01;
+	static const FCM::Double TWEEN_SCALE_TOLERANCE = 0.001;
+
 	FCM::Result TimelineWriter::PlaceObject(
 		FCM::U_Int32 resId,
 		FCM::U_Int32 objectId,
 		FCM::U_Int32 placeAfterObjectId,
 		const DOM::Utils::MATRIX2D* pMatrix,
-		const DOM::Utils::RECT* pRect /* = NULL */)
+		const DOM::Utils::RECT* pRect /* = NULL */,
+		const DOM::Utils::MATRIX2D* pMapAtoB /* = NULL */)
 	{
 		JSONNode commandElement(JSON_NODE);
 
@@ -39,9 +53,29 @@ namespace PixiJS
 		commandElement.push_back(JSONNode("instanceId", objectId));
 		commandElement.push_back(JSONNode("placeAfter", placeAfterObjectId));
 
+		if (pMapAtoB)
+		{
+			// The asset is a similar shape, map it onto the original first
+			m_instanceMaps[objectId] = *pMapAtoB;
+		}
+		else
+		{
+			m_instanceMaps.erase(objectId);
+		}
+
 		if (pMatrix)
 		{
-			commandElement.push_back(Utils::ToJSON("transform", *pMatrix));
+			DOM::Utils::MATRIX2D matrix = *pMatrix;
+			if (pMapAtoB)
+			{
+				Utils::ConcatMatrix(*pMatrix, *pMapAtoB, matrix);
+			}
+			commandElement.push_back(Utils::ToJSON("transform", matrix));
+			SetPlacedMatrix(objectId, &matrix);
+		}
+		else
+		{
+			SetPlacedMatrix(objectId, NULL);
 		}
 
 		if (pRect)
@@ -51,6 +85,15 @@ namespace PixiJS
 
 		m_pCommandArray->push_back(commandElement);
 
+		if (pMatrix)
+		{
+			AddTransformPoint(objectId, true);
+		}
+		else
+		{
+			EndTransformRun(objectId, false);
+		}
+
 		return FCM_SUCCESS;
 	}
 
@@ -76,6 +119,7 @@ namespace PixiJS
 		{
 			commandElement.push_back(Utils::ToJSON("transform", *pMatrix));
 		}
+		SetPlacedMatrix(objectId, pMatrix);
 
 		if (!instanceName.empty())
 		{
@@ -86,6 +130,15 @@ namespace PixiJS
 		commandElement.push_back(JSONNode("isGraphic", (bool)isGraphic));
 		m_pCommandArray->push_back(commandElement);
 
+		if (pMatrix)
+		{
+			AddTransformPoint(objectId, true);
+		}
+		else
+		{
+			EndTransformRun(objectId, false);
+		}
+
 		return FCM_SUCCESS;
 	}
 
@@ -150,6 +203,12 @@ namespace PixiJS
 		commandElement.push_back(JSONNode("type", "Remove"));
 		commandElement.push_back(JSONNode("instanceId", objectId));
 
+		m_instanceMaps.erase(objectId);
+		m_instanceMatrices.erase(objectId);
+
+		EndTransformRun(objectId, false);
+		m_transformRuns.erase(objectId);
+
 		m_pCommandArray->push_back(commandElement);
 
 		return FCM_SUCCESS;
@@ -624,7 +683,7 @@ namespace PixiJS
 
 					stopEntry.push_back(JSONNode("offset", (float)offset));
 					stopEntry.push_back(JSONNode("stopColor", Utils::ToString(colorPoint.color)));
-					stopEntry.push_back(JSONNode("stopOpacity", (float)(colorPoint.color.alpha / 255.0)));
+					stopEntry.push_back(JSONNode("stopOpacity", Utils::Round(colorPoint.color.alpha / 255.0, ALPHA_PRECISION)));
 					stopPointArray->set_name("GradientStops");
 					stopPointArray->push_back(stopEntry);
 				}
@@ -722,7 +781,7 @@ namespace PixiJS
 
 					stopEntry.push_back(JSONNode("offset", (float)offset));
 					stopEntry.push_back(JSONNode("stopColor", Utils::ToString(colorPoint.color)));
-					stopEntry.push_back(JSONNode("stopOpacity", (float)(colorPoint.color.alpha / 255.0)));
+					stopEntry.push_back(JSONNode("stopOpacity", Utils::Round(colorPoint.color.alpha / 255.0, ALPHA_PRECISION)));
 					stopPointsArray->set_name("GradientStops");
 					stopPointsArray->push_back(stopEntry);
 				}
@@ -777,14 +836,515 @@ namespace PixiJS
 
 		commandElement.push_back(JSONNode("type", "Move"));
 		commandElement.push_back(JSONNode("instanceId", objectId));
-		commandElement.push_back(Utils::ToJSON("transform", matrix));
+
+		// Most tweens only move the instance, the compiler fills in the
+		// components left out from the instance's previous matrix
+		std::map<FCM::U_Int32, DOM::Utils::MATRIX2D>::iterator it = m_instanceMaps.find(objectId);
+		if (it != m_instanceMaps.end())
+		{
+			DOM::Utils::MATRIX2D instanceMatrix;
+			Utils::ConcatMatrix(matrix, it->second, instanceMatrix);
+			commandElement.push_back(GetTransformDelta(objectId, instanceMatrix));
+		}
+		else
+		{
+			commandElement.push_back(GetTransformDelta(objectId, matrix));
+		}
 
 		m_pCommandArray->push_back(commandElement);
 
+		AddTransformPoint(objectId, false);
+
 		return FCM_SUCCESS;
 	}
 
 
+	// Components of a transform, in the order of WRITTEN_MATRIX
+	static const char* matrixFields[6] = { "a", "b", "c", "d", "tx", "ty" };
+
+	static void RoundMatrix(const DOM::Utils::MATRIX2D& matrix, FCM::Double values[6])
+	{
+		values[0] = Utils::Round(matrix.a, MATRIX_PRECISION);
+		values[1] = Utils::Round(matrix.b, MATRIX_PRECISION);
+		values[2] = Utils::Round(matrix.c, MATRIX_PRECISION);
+		values[3] = Utils::Round(matrix.d, MATRIX_PRECISION);
+		values[4] = Utils::Round(matrix.tx, MATRIX_PRECISION);
+		values[5] = Utils::Round(matrix.ty, MATRIX_PRECISION);
+	}
+
+	void TimelineWriter::SetPlacedMatrix(FCM::U_Int32 objectId, const DOM::Utils::MATRIX2D* pMatrix)
+	{
+		if (pMatrix == NULL)
+		{
+			m_instanceMatrices.erase(objectId);
+			return;
+		}
+
+		RoundMatrix(*pMatrix, m_instanceMatrices[objectId].values);
+	}
+
+
+	JSONNode TimelineWriter::GetTransformDelta(FCM::U_Int32 objectId, const DOM::Utils::MATRIX2D& matrix)
+	{
+		std::map<FCM::U_Int32, WRITTEN_MATRIX>::iterator it = m_instanceMatrices.find(objectId);
+		if (it == m_instanceMatrices.end())
+		{
+			SetPlacedMatrix(objectId, &matrix);
+			return Utils::ToJSON("transform", matrix);
+		}
+
+		// Compared as written so the rounding never drifts between frames
+		FCM::Double values[6];
+		RoundMatrix(matrix, values);
+
+		JSONNode json(JSON_NODE);
+		json.set_name("transform");
+		for (int i = 0; i < 6; i++)
+		{
+			if (values[i] != it->second.values[i])
+			{
+				json.push_back(JSONNode(matrixFields[i], values[i]));
+				it->second.values[i] = values[i];
+			}
+		}
+
+		return json;
+	}
+
+
+	void TimelineWriter::AddTransformPoint(FCM::U_Int32 objectId, bool isPlace)
+	{
+		TRANSFORM_POINT point;
+		point.frame = m_FrameCount;
+		point.command = (FCM::U_Int32)m_pCommandArray->size() - 1;
+		point.matrix = m_instanceMatrices[objectId];
+
+		if (isPlace)
+		{
+			EndTransformRun(objectId, false);
+		}
+
+		TRANSFORM_RUN& run = m_transformRuns[objectId];
+		if (run.empty() || run.back().frame + 1 != point.frame)
+		{
+			SaveTransformRun(run);
+			run.push_back(point);
+			return;
+		}
+
+		run.push_back(point);
+		if (!IsLinear(run))
+		{
+			// The matrix before this one ends the run and starts the next
+			run.pop_back();
+			TRANSFORM_POINT last = run.back();
+			SaveTransformRun(run);
+			run.push_back(last);
+			run.push_back(point);
+		}
+	}
+
+
+	void TimelineWriter::EndTransformRun(FCM::U_Int32 objectId, bool restart)
+	{
+		std::map<FCM::U_Int32, TRANSFORM_RUN>::iterator it = m_transformRuns.find(objectId);
+		if (it == m_transformRuns.end() || it->second.empty())
+		{
+			return;
+		}
+
+		TRANSFORM_RUN& run = it->second;
+		if (run.back().frame != m_FrameCount)
+		{
+			SaveTransformRun(run);
+			return;
+		}
+
+		TRANSFORM_POINT current = run.back();
+		run.pop_back();
+		SaveTransformRun(run);
+		if (restart)
+		{
+			run.push_back(current);
+		}
+	}
+
+
+	bool TimelineWriter::IsLinear(const TRANSFORM_RUN& run)
+	{
+		const FCM::Double* first = run.front().matrix.values;
+		const FCM::Double* last = run.back().matrix.values;
+
+		// The compiler tweens position and scale, skew and rotation have
+		// to stay put and the scale must not flip
+		if (first[1] != last[1] || first[2] != last[2])
+		{
+			return false;
+		}
+		if ((first[1] != 0 || first[2] != 0) && (first[0] != last[0] || first[3] != last[3]))
+		{
+			return false;
+		}
+		if (first[0] * last[0] < 0 || first[3] * last[3] < 0)
+		{
+			return false;
+		}
+
+		FCM::Double steps = (FCM::Double)(run.size() - 1);
+		for (size_t k = 1; k + 1 < run.size(); k++)
+		{
+			const FCM::Double* values = run[k].matrix.values;
+			if (values[1] != first[1] || values[2] != first[2])
+			{
+				return false;
+			}
+
+			for (int i = 0; i < 6; i++)
+			{
+				FCM::Double expected = first[i] + (last[i] - first[i]) * k / steps;
+				FCM::Double tolerance = i < 4 ? TWEEN_SCALE_TOLERANCE : TWEEN_POSITION_TOLERANCE;
+				if (fabs(values[i] - expected) > tolerance)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+
+	void TimelineWriter::SaveTransformRun(TRANSFORM_RUN& run)
+	{
+		if (run.size() >= MIN_TWEEN_FRAMES &&
+			!std::equal(run.front().matrix.values, run.front().matrix.values + 6, run.back().matrix.values))
+		{
+			m_linearRuns.push_back(run);
+		}
+		run.clear();
+	}
+
+
+	void TimelineWriter::CollapseTransformRuns()
+	{
+		for (std::map<FCM::U_Int32, TRANSFORM_RUN>::iterator it = m_transformRuns.begin(); it != m_transformRuns.end(); it++)
+		{
+			SaveTransformRun(it->second);
+		}
+		m_transformRuns.clear();
+
+		// Inside Moves to drop, by frame index
+		std::map<FCM::S_Int32, std::set<FCM::U_Int32> > dropped;
+
+		for (std::vector<TRANSFORM_RUN>::iterator run = m_linearRuns.begin(); run != m_linearRuns.end(); run++)
+		{
+			const TRANSFORM_POINT& first = run->front();
+			const TRANSFORM_POINT& last = run->back();
+			ASSERT(m_frameIndices[last.frame] >= 0);
+
+			// The last Move keeps the whole matrix and where the tween starts
+			JSONNode& frame = (*m_pFrameArray)[m_frameIndices[last.frame]];
+			JSONNode& command = (*frame.find("commands"))[last.command];
+			command.erase(command.find("transform"));
+
+			JSONNode transform(JSON_NODE);
+			transform.set_name("transform");
+			for (int i = 0; i < 6; i++)
+			{
+				transform.push_back(JSONNode(matrixFields[i], last.matrix.values[i]));
+			}
+			command.push_back(transform);
+			command.push_back(JSONNode("tweenStart", m_frameNumbers[first.frame]));
+
+			for (size_t k = 1; k + 1 < run->size(); k++)
+			{
+				dropped[m_frameIndices[(*run)[k].frame]].insert((*run)[k].command);
+			}
+		}
+		m_linearRuns.clear();
+
+		EraseCommands(dropped);
+	}
+
+
+	void TimelineWriter::EraseCommands(std::map<FCM::S_Int32, std::set<FCM::U_Int32> >& dropped)
+	{
+		// From the back so the indices still to visit stay put
+		for (std::map<FCM::S_Int32, std::set<FCM::U_Int32> >::reverse_iterator it = dropped.rbegin(); it != dropped.rend(); it++)
+		{
+			JSONNode& frame = (*m_pFrameArray)[it->first];
+			JSONNode::iterator commands = frame.find("commands");
+
+			for (std::set<FCM::U_Int32>::reverse_iterator index = it->second.rbegin(); index != it->second.rend(); index++)
+			{
+				commands->erase(commands->begin() + *index);
+			}
+
+			if (commands->empty())
+			{
+				frame.erase(commands);
+				if (frame.size() == 1)
+				{
+					// Nothing left but the frame number
+					m_pFrameArray->erase(m_pFrameArray->begin() + it->first);
+				}
+			}
+		}
+	}
+
+
+	void TimelineWriter::RemoveDeadCommands()
+	{
+		JSONNode identity(JSON_NODE);
+		identity.set_name("colorMatrix");
+		identity.push_back(JSONNode("r", 1));
+		identity.push_back(JSONNode("rA", 0));
+		identity.push_back(JSONNode("g", 1));
+		identity.push_back(JSONNode("gA", 0));
+		identity.push_back(JSONNode("b", 1));
+		identity.push_back(JSONNode("bA", 0));
+		identity.push_back(JSONNode("a", 1));
+		identity.push_back(JSONNode("aA", 0));
+
+		std::map<FCM::U_Int32, LIVE_INSTANCE> instances;
+		std::map<FCM::S_Int32, std::set<FCM::U_Int32> > dropped;
+
+		// Instances others are placed after, the compiler needs them to
+		// stack the display list even when they are never seen
+		std::set<FCM::U_Int32> anchors;
+		for (JSONNode::const_iterator frame = m_pFrameArray->begin(); frame != m_pFrameArray->end(); frame++)
+		{
+			JSONNode::const_iterator commands = frame->find("commands");
+			if (commands == frame->end())
+			{
+				continue;
+			}
+			for (JSONNode::const_iterator command = commands->begin(); command != commands->end(); command++)
+			{
+				if (command->at("type").as_string() == "Place")
+				{
+					anchors.insert((FCM::U_Int32)command->at("placeAfter").as_int());
+				}
+			}
+		}
+
+		for (FCM::U_Int32 i = 0; i < m_pFrameArray->size(); i++)
+		{
+			JSONNode::const_iterator commands = (*m_pFrameArray)[i].find("commands");
+			if (commands == (*m_pFrameArray)[i].end())
+			{
+				continue;
+			}
+
+			// Commands of the instances placed on this frame, and the
+			// instances masking or masked here
+			std::map<FCM::U_Int32, std::vector<FCM::U_Int32> > placedHere;
+			std::set<FCM::U_Int32> removedHere;
+			std::set<FCM::U_Int32> masks;
+
+			for (FCM::U_Int32 index = 0; index < commands->size(); index++)
+			{
+				const JSONNode& command = (*commands)[index];
+				std::string type = command.at("type").as_string();
+				FCM::U_Int32 objectId = (FCM::U_Int32)command.at("instanceId").as_int();
+
+				std::map<FCM::U_Int32, std::vector<FCM::U_Int32> >::iterator here = placedHere.find(objectId);
+				if (here != placedHere.end())
+				{
+					here->second.push_back(index);
+				}
+
+				if (type == "Place")
+				{
+					LIVE_INSTANCE& instance = instances[objectId];
+					instance.color = identity;
+					instance.visible = true;
+					instance.blendMode = "Normal";
+
+					// Named instances are reachable from code even when
+					// never seen, so they are always kept
+					if (command.find("instanceName") == command.end())
+					{
+						placedHere[objectId] = std::vector<FCM::U_Int32>(1, index);
+					}
+					continue;
+				}
+				if (type == "Remove")
+				{
+					instances.erase(objectId);
+					if (here != placedHere.end())
+					{
+						removedHere.insert(objectId);
+					}
+					continue;
+				}
+				if (type == "Mask")
+				{
+					masks.insert(objectId);
+					masks.insert((FCM::U_Int32)command.at("maskTill").as_int());
+					continue;
+				}
+
+				std::map<FCM::U_Int32, LIVE_INSTANCE>::iterator it = instances.find(objectId);
+				if (it == instances.end())
+				{
+					continue;
+				}
+
+				LIVE_INSTANCE& instance = it->second;
+				bool dead = false;
+
+				if (type == "Move")
+				{
+					dead = command.at("transform").empty() && command.find("tweenStart") == command.end();
+				}
+				else if (type == "ColorTransform")
+				{
+					dead = command.at("colorMatrix") == instance.color;
+					instance.color = command.at("colorMatrix");
+				}
+				else if (type == "Visibility")
+				{
+					bool visible = command.at("visibility").as_bool();
+					dead = visible == instance.visible;
+					instance.visible = visible;
+				}
+				else if (type == "BlendMode")
+				{
+					std::string blendMode = command.at("blendMode").as_string();
+					dead = blendMode == instance.blendMode;
+					instance.blendMode = blendMode;
+				}
+
+				if (dead)
+				{
+					dropped[i].insert(index);
+				}
+			}
+
+			// Placed and removed on the same frame, never seen
+			for (std::set<FCM::U_Int32>::iterator it = removedHere.begin(); it != removedHere.end(); it++)
+			{
+				if (masks.find(*it) == masks.end() && anchors.find(*it) == anchors.end())
+				{
+					const std::vector<FCM::U_Int32>& indices = placedHere[*it];
+					dropped[i].insert(indices.begin(), indices.end());
+				}
+			}
+		}
+
+		m_deadCommandCount = 0;
+		for (std::map<FCM::S_Int32, std::set<FCM::U_Int32> >::iterator it = dropped.begin(); it != dropped.end(); it++)
+		{
+			m_deadCommandCount += (FCM::U_Int32)it->second.size();
+		}
+
+		EraseCommands(dropped);
+	}
+
+
+	void TimelineWriter::AddPools()
+	{
+		std::map<FCM::U_Int32, POOL> pools;
+
+		// Asset of each instance on the display list
+		std::map<FCM::U_Int32, FCM::U_Int32> live;
+
+		for (JSONNode::const_iterator frame = m_pFrameArray->begin(); frame != m_pFrameArray->end(); frame++)
+		{
+			JSONNode::const_iterator commands = frame->find("commands");
+			if (commands == frame->end())
+			{
+				continue;
+			}
+			FCM::U_Int32 frameNum = (FCM::U_Int32)frame->at("frame").as_int();
+
+			// Removals first, an instance removed on a frame is gone by the
+			// time the frame's new instances show
+			for (int pass = 0; pass < 2; pass++)
+			{
+				for (JSONNode::const_iterator command = commands->begin(); command != commands->end(); command++)
+				{
+					std::string type = command->at("type").as_string();
+					if (type != (pass == 0 ? "Remove" : "Place"))
+					{
+						continue;
+					}
+
+					FCM::U_Int32 objectId = (FCM::U_Int32)command->at("instanceId").as_int();
+					std::map<FCM::U_Int32, FCM::U_Int32>::iterator it = live.find(objectId);
+					if (it != live.end())
+					{
+						POOL& pool = pools[it->second];
+						pool.alive--;
+						pool.free++;
+						live.erase(it);
+					}
+					if (pass == 0)
+					{
+						continue;
+					}
+
+					FCM::U_Int32 assetId = (FCM::U_Int32)command->at("assetId").as_int();
+					std::map<FCM::U_Int32, POOL>::iterator found = pools.find(assetId);
+					if (found == pools.end())
+					{
+						POOL empty = { 0, 0, 0, 0, 0, 0, 0 };
+						found = pools.insert(std::make_pair(assetId, empty)).first;
+					}
+
+					POOL& pool = found->second;
+					pool.placed++;
+					if (pool.free > 0)
+					{
+						pool.free--;
+						if (pool.reused++ == 0)
+						{
+							pool.firstReuse = frameNum;
+						}
+					}
+					if (++pool.alive > pool.maxAlive)
+					{
+						pool.maxAlive = pool.alive;
+						pool.peakFrame = frameNum;
+					}
+					live[objectId] = assetId;
+				}
+			}
+		}
+
+		JSONNode poolArray(JSON_ARRAY);
+		poolArray.set_name("pools");
+		for (std::map<FCM::U_Int32, POOL>::iterator it = pools.begin(); it != pools.end(); it++)
+		{
+			if (it->second.reused == 0)
+			{
+				continue;
+			}
+
+			JSONNode pool(JSON_NODE);
+			pool.push_back(JSONNode("assetId", it->first));
+			pool.push_back(JSONNode("maxAlive", it->second.maxAlive));
+			pool.push_back(JSONNode("peakFrame", it->second.peakFrame));
+			pool.push_back(JSONNode("placed", it->second.placed));
+			pool.push_back(JSONNode("reused", it->second.reused));
+			pool.push_back(JSONNode("firstReuse", it->second.firstReuse));
+			poolArray.push_back(pool);
+		}
+
+		if (!poolArray.empty())
+		{
+			m_pTimelineElement->push_back(poolArray);
+		}
+	}
+
+
+	FCM::U_Int32 TimelineWriter::GetDeadCommandCount() const
+	{
+		return m_deadCommandCount;
+	}
+
+
 	FCM::Result TimelineWriter::UpdateColorTransform(
 		FCM::U_Int32 objectId,
 		const DOM::Utils::COLOR_MATRIX& colorMatrix)
@@ -795,6 +1355,10 @@ namespace PixiJS
 		commandElement.push_back(JSONNode("instanceId", objectId));
 		commandElement.push_back(Utils::ToJSON("colorMatrix", colorMatrix));
 
+		// The compiler keeps the colors of a tween's end frame for the
+		// whole tween, a color change cannot happen inside one
+		EndTransformRun(objectId, true);
+
 		m_pCommandArray->push_back(commandElement);
 
 		return FCM_SUCCESS;
@@ -824,9 +1388,15 @@ namespace PixiJS
 			showFrame = true;
 		}
 
+		m_frameNumbers.push_back(frameNum);
 		if (showFrame)
 		{
 			m_pFrameArray->push_back(*m_pFrameElement);
+			m_frameIndices.push_back((FCM::S_Int32)m_pFrameArray->size() - 1);
+		}
+		else
+		{
+			m_frameIndices.push_back(-1);
 		}
 
 		m_FrameCount++;
@@ -919,6 +1489,9 @@ namespace PixiJS
 		ASSERT(m_pFrameScripts);
 
 		m_FrameCount = 0;
+		m_seekInterval = 0;
+		m_tweenMoves = false;
+		m_deadCommandCount = 0;
 	}
 
 
@@ -962,6 +1535,156 @@ namespace PixiJS
 
 		m_pTimelineElement->push_back(JSONNode("name", name.c_str()));
 		m_pTimelineElement->push_back(JSONNode("totalFrames", m_FrameCount));
+
+		// Before the Moves inside tweens are dropped
+		if (m_seekInterval > 0)
+		{
+			AddSnapshots();
+		}
+
+		if (m_tweenMoves)
+		{
+			CollapseTransformRuns();
+		}
+		RemoveDeadCommands();
+		AddPools();
 		m_pTimelineElement->push_back(*m_pFrameArray);
 	}
+
+
+	void TimelineWriter::SetSeekInterval(FCM::U_Int32 interval)
+	{
+		m_seekInterval = interval;
+	}
+
+
+	void TimelineWriter::SetTweenMoves(bool tweenMoves)
+	{
+		m_tweenMoves = tweenMoves;
+	}
+
+
+	// Replace or add a named child
+	static void SetChild(JSONNode& node, const JSONNode& child)
+	{
+		JSONNode::iterator it = node.find(child.name());
+		if (it != node.end())
+		{
+			*it = child;
+		}
+		else
+		{
+			node.push_back(child);
+		}
+	}
+
+
+	void TimelineWriter::AddSnapshots()
+	{
+		// State of each instance on the display list, as the fields of
+		// its commands, and the order they were last placed in
+		std::map<FCM::U_Int32, JSONNode> instances;
+		std::map<FCM::U_Int32, FCM::U_Int32> placed;
+		FCM::U_Int32 placeCount = 0;
+
+		JSONNode snapshots(JSON_ARRAY);
+		snapshots.set_name("snapshots");
+
+		FCM::U_Int32 nextFrame = m_seekInterval;
+		JSONNode::const_iterator frame = m_pFrameArray->begin();
+
+		while (nextFrame < m_FrameCount)
+		{
+			// Apply every frame up to the snapshot's
+			for (; frame != m_pFrameArray->end() && (FCM::U_Int32)frame->at("frame").as_int() <= nextFrame; frame++)
+			{
+				JSONNode::const_iterator commands = frame->find("commands");
+				if (commands == frame->end())
+				{
+					continue;
+				}
+
+				for (JSONNode::const_iterator command = commands->begin(); command != commands->end(); command++)
+				{
+					std::string type = command->at("type").as_string();
+					FCM::U_Int32 objectId = (FCM::U_Int32)command->at("instanceId").as_int();
+
+					if (type == "Place")
+					{
+						JSONNode instance(*command);
+						instance.erase(instance.find("type"));
+						instances[objectId] = instance;
+						placed[objectId] = placeCount++;
+					}
+					else if (type == "Remove")
+					{
+						instances.erase(objectId);
+						placed.erase(objectId);
+					}
+					else if (instances.find(objectId) == instances.end() || type == "Filter")
+					{
+						// Sounds are not on the display list, filters are left out
+						continue;
+					}
+					else if (type == "Move")
+					{
+						JSONNode& instance = instances[objectId];
+						const JSONNode& delta = command->at("transform");
+						JSONNode::iterator transform = instance.find("transform");
+						if (transform == instance.end())
+						{
+							instance.push_back(delta);
+							continue;
+						}
+						for (JSONNode::const_iterator field = delta.begin(); field != delta.end(); field++)
+						{
+							SetChild(*transform, *field);
+						}
+					}
+					else
+					{
+						JSONNode& instance = instances[objectId];
+						for (JSONNode::const_iterator field = command->begin(); field != command->end(); field++)
+						{
+							if (field->name() == "visibility")
+							{
+								SetChild(instance, JSONNode("visible", field->as_bool()));
+							}
+							else if (field->name() != "type" && field->name() != "instanceId")
+							{
+								SetChild(instance, *field);
+							}
+						}
+						if (type == "ZOrder")
+						{
+							placed[objectId] = placeCount++;
+						}
+					}
+				}
+			}
+
+			// In the order they were placed so each placeAfter is met first
+			std::map<FCM::U_Int32, FCM::U_Int32> order;
+			for (std::map<FCM::U_Int32, FCM::U_Int32>::iterator it = placed.begin(); it != placed.end(); it++)
+			{
+				order[it->second] = it->first;
+			}
+
+			JSONNode live(JSON_ARRAY);
+			live.set_name("instances");
+			for (std::map<FCM::U_Int32, FCM::U_Int32>::iterator it = order.begin(); it != order.end(); it++)
+			{
+				live.push_back(instances[it->second]);
+			}
+
+			JSONNode snapshot(JSON_NODE);
+			snapshot.push_back(JSONNode("frame", nextFrame));
+			snapshot.push_back(live);
+			snapshots.push_back(snapshot);
+
+			nextFrame += m_seekInterval;
+		}
+
+		m_pTimelineElement->push_back(snapshots);
+	}
 };
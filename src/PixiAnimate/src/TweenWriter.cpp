@@ -87,6 +87,7 @@ namespace PixiJS
 			timelineElement.push_back(tweensArray);
 			m_pTweenArray->push_back(timelineElement);
 		}
+		return FCM_SUCCESS;
 	}
 
 	TweenWriter::TweenWriter(FCM::PIFCMCallback pCallback) :
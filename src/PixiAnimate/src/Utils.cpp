@@ -18,37 +18,43 @@
 
 #include "PluginConfiguration.h"
 #include "Utils.h"
+#include "Process.h"
 
 #ifdef _WINDOWS
-#ifdef USE_HTTP_SERVER
 #include <WinSock.h>
-#endif
+#pragma comment(lib, "Ws2_32.lib")
 #include "Windows.h"
 #include "ShellApi.h"
 #include "ShlObj.h"
+#include <io.h>
+#include <fcntl.h>
 #endif
 
 #ifdef __APPLE__
 #include "CoreFoundation/CoreFoundation.h"
 #include <dlfcn.h>
-#ifdef USE_HTTP_SERVER    
 #include <sys/socket.h>
+#include <sys/time.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
-#include <sys/stat.h>    
-#endif    
+#include <sys/stat.h>
 #include <copyfile.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
 #endif
 
 #include <cctype>
 #include <iomanip>
 #include <algorithm>
 #include <sstream>
+#include <map>
 
 #include "IFCMStringUtils.h"
 
 #include <string>
 #include <cstring>
+#include <cmath>
 #include <stdlib.h>
 #include "JSONNode.h"
 #include "Application/Service/IOutputConsoleService.h"
@@ -64,6 +70,19 @@ EXTERN_C IMAGE_DOS_HEADER __ImageBase;
 namespace PixiJS
 {
 	static std::string comma = ",";
+
+	static int precision[PRECISION_COUNT] =
+	{
+		MAX_PRECISION,
+		MAX_PRECISION,
+		MAX_PRECISION,
+		MAX_PRECISION
+	};
+
+	static const double powersOfTen[MAX_PRECISION + 1] =
+	{
+		1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0
+	};
 }
 
 const std::string FixSlashes(const std::string& path) {
@@ -81,6 +100,169 @@ const std::string FixSlashes(const std::string& path) {
 
 /* -------------------------------------------------- Static Functions */
 
+namespace PixiJS
+{
+	// A file or folder found by ListDir
+	struct DirEntry
+	{
+		bool isDir;
+		FCM::U_Int64 size;
+		FCM::U_Int64 modified;
+	};
+
+#ifdef _WINDOWS
+	static std::wstring ToWidePath(const std::string& path, FCM::PIFCMCallback pCallback)
+	{
+		FCM::StringRep16 pathStr = Utils::ToString16(FixSlashes(path), pCallback);
+		std::wstring wstr((const wchar_t *)pathStr);
+
+		FCM::AutoPtr<FCM::IFCMCalloc> pCalloc = Utils::GetCallocService(pCallback);
+		ASSERT(pCalloc.m_Ptr != NULL);
+		pCalloc->Free(pathStr);
+
+		return wstr;
+	}
+#endif
+
+	// Get the entries of a folder by name, without "." and ".."
+	static bool ListDir(
+		const std::string& folder,
+		std::map<std::string, DirEntry>& entries,
+		FCM::PIFCMCallback pCallback)
+	{
+#ifdef _WINDOWS
+		WIN32_FIND_DATAW data;
+		HANDLE hFind = ::FindFirstFileW(ToWidePath(folder + "/*", pCallback).c_str(), &data);
+		if (hFind == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		do
+		{
+			if (wcscmp(data.cFileName, L".") == 0 || wcscmp(data.cFileName, L"..") == 0)
+			{
+				continue;
+			}
+
+			DirEntry entry;
+			entry.isDir = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+			entry.size = ((FCM::U_Int64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+			entry.modified = ((FCM::U_Int64)data.ftLastWriteTime.dwHighDateTime << 32) |
+				data.ftLastWriteTime.dwLowDateTime;
+
+			entries[Utils::ToString((FCM::CStringRep16)data.cFileName, pCallback)] = entry;
+		}
+		while (::FindNextFileW(hFind, &data));
+
+		::FindClose(hFind);
+		return true;
+#else
+		DIR* pDir = opendir(folder.c_str());
+		if (pDir == NULL)
+		{
+			return false;
+		}
+
+		struct dirent* pEntry;
+		while ((pEntry = readdir(pDir)) != NULL)
+		{
+			std::string name = pEntry->d_name;
+			struct stat sb;
+			if (name == "." || name == ".." || lstat((folder + "/" + name).c_str(), &sb) != 0)
+			{
+				continue;
+			}
+
+			DirEntry entry;
+			entry.isDir = S_ISDIR(sb.st_mode);
+			entry.size = sb.st_size;
+			entry.modified = sb.st_mtime;
+			entries[name] = entry;
+		}
+
+		closedir(pDir);
+		return true;
+#endif
+	}
+
+	// Compare two files of the same size byte by byte
+	static bool SameContent(const std::string& fileA, const std::string& fileB, FCM::PIFCMCallback pCallback)
+	{
+		std::fstream a;
+		std::fstream b;
+		Utils::OpenFStream(fileA, a, std::ios_base::in | std::ios_base::binary, pCallback);
+		Utils::OpenFStream(fileB, b, std::ios_base::in | std::ios_base::binary, pCallback);
+		if (!a.is_open() || !b.is_open())
+		{
+			return false;
+		}
+
+		char bufferA[65536];
+		char bufferB[65536];
+		while (a && b)
+		{
+			a.read(bufferA, sizeof(bufferA));
+			b.read(bufferB, sizeof(bufferB));
+			if (a.gcount() != b.gcount() || memcmp(bufferA, bufferB, (size_t)a.gcount()) != 0)
+			{
+				return false;
+			}
+		}
+
+		return a.eof() && b.eof();
+	}
+
+	// Copy one file over another, keeping its modification time. Clones
+	// the file where the file system can share its blocks.
+	static bool CopyOneFile(const std::string& srcFile, const std::string& dstFile, FCM::PIFCMCallback pCallback)
+	{
+#ifdef _WINDOWS
+		// Windows clones on its own on volumes that support block cloning
+		return ::CopyFileW(
+			ToWidePath(srcFile, pCallback).c_str(),
+			ToWidePath(dstFile, pCallback).c_str(),
+			FALSE) != FALSE;
+#else
+		// Cloning won't replace an existing file
+		unlink(dstFile.c_str());
+
+#ifdef COPYFILE_CLONE
+		if (copyfile(srcFile.c_str(), dstFile.c_str(), NULL, COPYFILE_CLONE) == 0)
+		{
+			return true;
+		}
+#endif
+		return copyfile(srcFile.c_str(), dstFile.c_str(), NULL, COPYFILE_ALL) == 0;
+#endif
+	}
+
+	// Delete a file or a folder with everything in it
+	static bool RemoveEntry(const std::string& path, bool isDir, FCM::PIFCMCallback pCallback)
+	{
+#ifdef _WINDOWS
+		if (isDir)
+		{
+			return FCM_SUCCESS_CODE(Utils::Remove(path, pCallback));
+		}
+		return ::DeleteFileW(ToWidePath(path, pCallback).c_str()) != FALSE;
+#else
+		if (!isDir)
+		{
+			return unlink(path.c_str()) == 0;
+		}
+
+		std::map<std::string, DirEntry> entries;
+		ListDir(path, entries, pCallback);
+		for (std::map<std::string, DirEntry>::iterator it = entries.begin(); it != entries.end(); it++)
+		{
+			RemoveEntry(path + "/" + it->first, it->second.isDir, pCallback);
+		}
+		return rmdir(path.c_str()) == 0;
+#endif
+	}
+}
+
 
 /* -------------------------------------------------- Utils */
 
@@ -209,6 +391,56 @@ namespace PixiJS
 		return b ? "true" : "false";
 	}
 
+	FCM::U_Int64 Utils::Hash(const std::string& content)
+	{
+		// 64-bit FNV-1a
+		FCM::U_Int64 hash = 14695981039346656037ULL;
+		for (std::string::const_iterator i = content.begin(); i != content.end(); i++)
+		{
+			hash ^= (unsigned char)*i;
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	FCM::U_Int64 Utils::CheckHash(const std::string& content)
+	{
+		// 64-bit MurmurHash2 (MurmurHash64A)
+		const FCM::U_Int64 m = 0xc6a4a7935bd1e995ULL;
+		const int r = 47;
+		const unsigned char* data = (const unsigned char*)content.data();
+		size_t length = content.size();
+		FCM::U_Int64 hash = 0x5bd1e995ULL ^ (length * m);
+
+		for (; length >= 8; length -= 8, data += 8)
+		{
+			FCM::U_Int64 k = 0;
+			for (int i = 7; i >= 0; i--)
+			{
+				k = (k << 8) | data[i];
+			}
+			k *= m;
+			k ^= k >> r;
+			k *= m;
+			hash ^= k;
+			hash *= m;
+		}
+
+		if (length > 0)
+		{
+			for (size_t i = length; i > 0; i--)
+			{
+				hash ^= (FCM::U_Int64)data[i - 1] << (8 * (i - 1));
+			}
+			hash *= m;
+		}
+
+		hash ^= hash >> r;
+		hash *= m;
+		hash ^= hash >> r;
+		return hash;
+	}
+
 	void Utils::RemoveTrailingZeroes(char *str)
 	{
 		char *ptr;
@@ -257,12 +489,12 @@ namespace PixiJS
 	JSONNode Utils::ToJSON(const std::string& name, const DOM::Utils::MATRIX2D& matrix)
 	{
 		JSONNode json;
-		json.push_back(JSONNode("a", matrix.a));
-		json.push_back(JSONNode("b", matrix.b));
-		json.push_back(JSONNode("c", matrix.c));
-		json.push_back(JSONNode("d", matrix.d));
-		json.push_back(JSONNode("tx", matrix.tx));
-		json.push_back(JSONNode("ty", matrix.ty));
+		json.push_back(JSONNode("a", Round(matrix.a, MATRIX_PRECISION)));
+		json.push_back(JSONNode("b", Round(matrix.b, MATRIX_PRECISION)));
+		json.push_back(JSONNode("c", Round(matrix.c, MATRIX_PRECISION)));
+		json.push_back(JSONNode("d", Round(matrix.d, MATRIX_PRECISION)));
+		json.push_back(JSONNode("tx", Round(matrix.tx, MATRIX_PRECISION)));
+		json.push_back(JSONNode("ty", Round(matrix.ty, MATRIX_PRECISION)));
 		json.set_name(name);
 		return json;
 	}
@@ -271,14 +503,14 @@ namespace PixiJS
 	{
 		JSONNode json;
 		json.set_name(name);
-		json.push_back(JSONNode("r", colorMatrix.matrix[0][0]));
-		json.push_back(JSONNode("rA", colorMatrix.matrix[0][4] / 255));
-		json.push_back(JSONNode("g", colorMatrix.matrix[1][1]));
-		json.push_back(JSONNode("gA", colorMatrix.matrix[1][4] / 255));
-		json.push_back(JSONNode("b", colorMatrix.matrix[2][2]));
-		json.push_back(JSONNode("bA", colorMatrix.matrix[2][4] / 255));
-		json.push_back(JSONNode("a", colorMatrix.matrix[3][3]));
-		json.push_back(JSONNode("aA", colorMatrix.matrix[3][4] / 255));
+		json.push_back(JSONNode("r", Round(colorMatrix.matrix[0][0], COLOR_PRECISION)));
+		json.push_back(JSONNode("rA", Round(colorMatrix.matrix[0][4] / 255, COLOR_PRECISION)));
+		json.push_back(JSONNode("g", Round(colorMatrix.matrix[1][1], COLOR_PRECISION)));
+		json.push_back(JSONNode("gA", Round(colorMatrix.matrix[1][4] / 255, COLOR_PRECISION)));
+		json.push_back(JSONNode("b", Round(colorMatrix.matrix[2][2], COLOR_PRECISION)));
+		json.push_back(JSONNode("bA", Round(colorMatrix.matrix[2][4] / 255, COLOR_PRECISION)));
+		json.push_back(JSONNode("a", Round(colorMatrix.matrix[3][3], COLOR_PRECISION)));
+		json.push_back(JSONNode("aA", Round(colorMatrix.matrix[3][4] / 255, COLOR_PRECISION)));
 		return json;
 	}
 
@@ -567,6 +799,46 @@ namespace PixiJS
 		outPoint = loc;
 	}
 
+	void Utils::SetPrecision(PrecisionCategory category, int decimals)
+	{
+		if (decimals < 0)
+		{
+			decimals = 0;
+		}
+		else if (decimals > MAX_PRECISION)
+		{
+			decimals = MAX_PRECISION;
+		}
+		precision[category] = decimals;
+	}
+
+	double Utils::Round(double value, PrecisionCategory category)
+	{
+		if (precision[category] == MAX_PRECISION)
+		{
+			return value;
+		}
+		double scale = powersOfTen[precision[category]];
+		return floor(value * scale + 0.5) / scale;
+	}
+
+	void Utils::ConcatMatrix(
+		const DOM::Utils::MATRIX2D& m1,
+		const DOM::Utils::MATRIX2D& m2,
+		DOM::Utils::MATRIX2D& outMatrix)
+	{
+		DOM::Utils::MATRIX2D mat;
+
+		mat.a = m1.a * m2.a + m1.c * m2.b;
+		mat.b = m1.b * m2.a + m1.d * m2.b;
+		mat.c = m1.a * m2.c + m1.c * m2.d;
+		mat.d = m1.b * m2.c + m1.d * m2.d;
+		mat.tx = m1.a * m2.tx + m1.c * m2.ty + m1.tx;
+		mat.ty = m1.b * m2.tx + m1.d * m2.ty + m1.ty;
+
+		outMatrix = mat;
+	}
+
 	void Utils::GetParent(const std::string& path, std::string& parent)
 	{
 		size_t index = path.find_last_of("/\\");
@@ -753,6 +1025,18 @@ namespace PixiJS
 #endif
 	}
 
+	FCM::Result Utils::GetCacheDir(FCM::PIFCMCallback pCallback, std::string& path)
+	{
+		FCM::Result res = GetAppTempDir(pCallback, path);
+		if (FCM_FAILURE_CODE(res))
+		{
+			return res;
+		}
+
+		path += "AssetCache";
+		return CreateDir(path, pCallback);
+	}
+
 	void Utils::OpenFStream(const std::string& outputFile, std::fstream &file, std::ios_base::openmode mode, FCM::PIFCMCallback pCallback)
 	{
 
@@ -847,9 +1131,11 @@ namespace PixiJS
 		pCalloc->Free(folderStr);
 
 #else
-		std::string delFolder = folder + "/";
-		std::string cmd = "rm -rf " + delFolder;
-		std::system(cmd.c_str());
+		struct stat sb;
+		if (lstat(folder.c_str(), &sb) == 0 && !RemoveEntry(folder, S_ISDIR(sb.st_mode), pCallback))
+		{
+			return FCM_GENERAL_ERROR;
+		}
 #endif
 
 		return FCM_SUCCESS;
@@ -902,6 +1188,75 @@ namespace PixiJS
 	}
 
 
+	// Makes dstFolder a copy of srcFolder. Only files whose size or
+	// modification time differ and whose content changed are copied, and
+	// entries no longer in srcFolder are deleted.
+	FCM::Result Utils::SyncDir(
+		const std::string& srcFolder,
+		const std::string& dstFolder,
+		FCM::PIFCMCallback pCallback,
+		FCM::U_Int32& copiedCount)
+	{
+		std::map<std::string, DirEntry> srcEntries;
+		std::map<std::string, DirEntry> dstEntries;
+
+		if (!ListDir(srcFolder, srcEntries, pCallback))
+		{
+			return FCM_GENERAL_ERROR;
+		}
+
+		FCM::Result res = CreateDir(dstFolder, pCallback);
+		if (FCM_FAILURE_CODE(res))
+		{
+			return res;
+		}
+		ListDir(dstFolder, dstEntries, pCallback);
+
+		// Stale files first, a file may be replaced by a folder of the same name
+		for (std::map<std::string, DirEntry>::iterator it = dstEntries.begin(); it != dstEntries.end(); it++)
+		{
+			std::map<std::string, DirEntry>::iterator src = srcEntries.find(it->first);
+			if (src == srcEntries.end() || src->second.isDir != it->second.isDir)
+			{
+				RemoveEntry(dstFolder + "/" + it->first, it->second.isDir, pCallback);
+			}
+		}
+
+		for (std::map<std::string, DirEntry>::iterator it = srcEntries.begin(); it != srcEntries.end(); it++)
+		{
+			std::string srcPath = srcFolder + "/" + it->first;
+			std::string dstPath = dstFolder + "/" + it->first;
+
+			if (it->second.isDir)
+			{
+				res = SyncDir(srcPath, dstPath, pCallback, copiedCount);
+				if (FCM_FAILURE_CODE(res))
+				{
+					return res;
+				}
+				continue;
+			}
+
+			std::map<std::string, DirEntry>::iterator dst = dstEntries.find(it->first);
+			if (dst != dstEntries.end() &&
+				!dst->second.isDir &&
+				dst->second.size == it->second.size &&
+				(dst->second.modified == it->second.modified || SameContent(srcPath, dstPath, pCallback)))
+			{
+				continue;
+			}
+
+			if (!CopyOneFile(srcPath, dstPath, pCallback))
+			{
+				return FCM_GENERAL_ERROR;
+			}
+			copiedCount++;
+		}
+
+		return FCM_SUCCESS;
+	}
+
+
 	// Copies a source file to a destination folder. 
 	FCM::Result Utils::CopyAFile(const std::string& srcFile, const std::string& dstFolder, FCM::PIFCMCallback pCallback)
 	{
@@ -1036,64 +1391,80 @@ namespace PixiJS
 		}
 	}
 
-	int Utils::RunElectron(std::string argline)
+	// Electron is installed globally by npm, on Windows as a batch file
+	static void GetElectronCommand(const std::string& argline, std::string& program, std::string& args)
 	{
 #ifdef _WINDOWS
-		STARTUPINFO si;
-		PROCESS_INFORMATION pi;
-
-		std::string cmd = "C:\\Windows\\System32\\cmd.exe /C electron " + argline;
-
-		std::wstring wcmd;
-		wcmd.assign(cmd.begin(), cmd.end());
-
-		ZeroMemory(&si, sizeof(si));
-		si.cb = sizeof(si);
-		si.wShowWindow = SW_HIDE;
-		si.cb = sizeof(si);
-		si.dwFlags = STARTF_USESHOWWINDOW;
-		ZeroMemory(&pi, sizeof(pi));
-
-		// Start the child process. 
-		if (!CreateProcess(NULL,   // No module name (use command line)
-			(LPWSTR)wcmd.c_str(),        // Command line
-			NULL,           // Process handle not inheritable
-			NULL,           // Thread handle not inheritable
-			FALSE,          // Set handle inheritance to FALSE
-			0,              // No creation flags
-			NULL,           // Use parent's environment block
-			NULL,           // Use parent's starting directory 
-			&si,            // Pointer to STARTUPINFO structure
-			&pi)           // Pointer to PROCESS_INFORMATION structure
-			)
-		{
-			printf("CreateProcess for (%S) failed (%d).\n", wcmd.c_str(), GetLastError());
+		program = "C:\\Windows\\System32\\cmd.exe";
+		args = "/C electron " + argline;
+#else
+		program = "/usr/local/bin/node";
+		args = "/usr/local/bin/electron " + argline;
+#endif
+	}
+
+	int Utils::RunElectron(std::string argline, int timeoutMs, FCM::PIFCMCallback pCallback)
+	{
+		std::string program;
+		std::string args;
+		GetElectronCommand(argline, program, args);
+
+		Process process;
+		if (!process.Start(program, args, Process::CAPTURE_OUTPUT))
+		{
 			return 1;
 		}
 
-		// Wait until child process exits.
-		WaitForSingleObject(pi.hProcess, INFINITE);
+		int exitCode;
+		if (!process.Wait(timeoutMs, exitCode))
+		{
+			process.Kill();
+			if (pCallback)
+			{
+				Utils::Trace(pCallback, "ERROR: Electron did not finish in %d seconds\n", timeoutMs / 1000);
+			}
+			return 1;
+		}
 
-		// Get the exit code
-		DWORD exit_code;
-		GetExitCodeProcess(pi.hProcess, &exit_code);
+		if (exitCode != 0 && pCallback)
+		{
+			Utils::Trace(pCallback, "ERROR: Electron exited with code %d\n%s\n", exitCode, process.GetOutput().c_str());
+		}
+		return exitCode;
+	}
 
-		// Close process and thread handles. 
-		CloseHandle(pi.hProcess);
-		CloseHandle(pi.hThread);
-		return exit_code;
+	Process* Utils::OpenElectron(std::string argline)
+	{
+		std::string program;
+		std::string args;
+		GetElectronCommand(argline, program, args);
 
-#else
-		std::string cmd = "/usr/local/bin/node /usr/local/bin/electron " + argline;
-		FILE *in;
-		char buff[512];
-		if (!(in = popen(cmd.c_str(), "r"))) {
-			return 1;
+		Process* pProcess = new Process();
+		ASSERT(pProcess);
+
+		if (!pProcess->Start(program, args, Process::PIPE_INPUT | Process::CAPTURE_OUTPUT) ||
+			pProcess->GetInput() == NULL)
+		{
+			delete pProcess;
+			return NULL;
 		}
-		while (fgets(buff, sizeof(buff), in) != NULL) {};
-		int a = pclose(in);
-		return WEXITSTATUS(a);
-#endif
+		return pProcess;
+	}
+
+	int Utils::CloseElectron(Process* pProcess, FCM::PIFCMCallback pCallback)
+	{
+		pProcess->CloseInput();
+
+		int exitCode;
+		pProcess->Wait(0, exitCode);
+
+		if (exitCode != 0 && pCallback)
+		{
+			Utils::Trace(pCallback, "ERROR: Electron exited with code %d\n%s\n", exitCode, pProcess->GetOutput().c_str());
+		}
+
+		delete pProcess;
+		return exitCode;
 	}
 
 
@@ -1121,12 +1492,18 @@ namespace PixiJS
 		output += Utils::ToString(port);
 		output += "/";
 		output += outputFile;
-		std::string str = "/usr/bin/open " + output;
-		popen(str.c_str(), "r");
+		// open returns as soon as the browser has the page
+		Process process;
+		int exitCode;
+		if (process.Start("/usr/bin/open", output, 0))
+		{
+			process.Wait(0, exitCode);
+		}
 
 #endif // _WINDOWS
 
 	}
+#endif // USE_HTTP_SERVER
 
 	int Utils::GetUnusedLocalPort()
 	{
@@ -1134,8 +1511,6 @@ namespace PixiJS
 
 		InitSockAddr(&client);
 
-		SOCKET sock = socket(PF_INET, SOCK_STREAM, 0);
-
 		// Look for a port in the private port range
 		int minPortNumber = 49152;
 		int maxPortNumber = 65535;
@@ -1152,6 +1527,8 @@ namespace PixiJS
 		{
 			client.sin_port = htons(port);
 
+			// A socket can't connect again once closed, use a new one per try
+			SOCKET sock = socket(PF_INET, SOCK_STREAM, 0);
 			int result = connect(sock, (struct sockaddr *) &client, sizeof(client));
 
 			CLOSE_SOCKET(sock);
@@ -1174,6 +1551,94 @@ namespace PixiJS
 		return port;
 	}
 
+	bool Utils::StartSockets()
+	{
+#ifdef _WINDOWS
+		static bool started = false;
+		if (!started)
+		{
+			WSADATA wsaData;
+			started = WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+		}
+		return started;
+#else
+		return true;
+#endif
+	}
+
+	bool Utils::SendRequest(int port, const std::string& request, std::string& reply, int timeoutMs)
+	{
+		sockaddr_in server;
+		InitSockAddr(&server);
+		server.sin_port = htons(port);
+
+		SOCKET sock = socket(PF_INET, SOCK_STREAM, 0);
+		if (sock == (SOCKET)-1)
+		{
+			return false;
+		}
+
+		if (timeoutMs > 0)
+		{
+#ifdef _WINDOWS
+			DWORD timeout = timeoutMs;
+#else
+			struct timeval timeout;
+			timeout.tv_sec = timeoutMs / 1000;
+			timeout.tv_usec = (timeoutMs % 1000) * 1000;
+#endif
+			setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+		}
+
+#ifdef SO_NOSIGPIPE
+		// A server that went away must fail the send, not kill the host
+		int noSigPipe = 1;
+		setsockopt(sock, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+		if (connect(sock, (struct sockaddr *) &server, sizeof(server)) != 0)
+		{
+			CLOSE_SOCKET(sock);
+			return false;
+		}
+
+		std::string line = request + "\n";
+		size_t sent = 0;
+		while (sent < line.size())
+		{
+			int count = send(sock, line.c_str() + sent, (int)(line.size() - sent), 0);
+			if (count <= 0)
+			{
+				CLOSE_SOCKET(sock);
+				return false;
+			}
+			sent += count;
+		}
+
+		// The reply is a single line
+		reply.clear();
+		char buffer[512];
+		bool complete = false;
+		while (!complete)
+		{
+			int count = recv(sock, buffer, sizeof(buffer), 0);
+			if (count <= 0)
+			{
+				break;
+			}
+			reply.append(buffer, count);
+			complete = reply.find('\n') != std::string::npos;
+		}
+		CLOSE_SOCKET(sock);
+
+		if (!complete)
+		{
+			return false;
+		}
+		reply.erase(reply.find('\n'));
+
+		return true;
+	}
 	void Utils::InitSockAddr(sockaddr_in* sockAddr)
 	{
 		ASSERT(sockAddr);
@@ -1191,7 +1656,5 @@ namespace PixiJS
 #endif
 
 	}
-
-#endif // USE_HTTP_SERVER
 }
 
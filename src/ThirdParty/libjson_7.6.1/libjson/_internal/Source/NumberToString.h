@@ -116,6 +116,68 @@ public:
 	   #define LFLOAT_STRING L"%Lf"
     #endif
 
+    //PixiAnimate: not part of libjson 7.6.1. _fixedtoa and its call in
+    //_ftoa print most numbers without printf, remove both to get the stock
+    //library back. PixiAnimateNumberFormat checks and times them against it.
+    #ifndef JSON_ISO_STRICT
+	   #define FIXED_DECIMALS 6
+	   #define FIXED_SCALE 1000000.0
+	   #define FIXED_LIMIT 1000000000.0
+
+	   //Prints a number with the same digits as FLOAT_STRING with the trailing
+	   //zeros stripped. Returns false when the number is too close to halfway
+	   //between two outputs to round from the scaled double, printf rounds
+	   //those from the exact value instead
+	   static bool _fixedtoa(json_number value, json_string & result) json_nothrow {
+		  json_char num_str_result[32];
+		  json_char * runner = &num_str_result[31];
+		  *runner = JSON_TEXT('\0');
+
+		  bool negative = value < 0;
+		  if (negative){
+			 value = -value;
+		  }
+
+		  //The multiply is off by up to half an ulp, so the fraction it leaves
+		  //can be on the wrong side of .5 when the exact value is close to it
+		  json_number exact = value * FIXED_SCALE;
+		  unsigned long long scaled = (unsigned long long)exact;
+		  json_number rest = exact - (json_number)scaled;
+		  json_number error = exact * std::numeric_limits<json_number>::epsilon();
+		  if (json_unlikely(rest > 0.5 - error && rest < 0.5 + error)){
+			 return false;
+		  }
+		  if (rest > 0.5){
+			 ++scaled;
+		  }
+		  unsigned long long whole = scaled / (unsigned long long)FIXED_SCALE;
+		  unsigned long long frac = scaled % (unsigned long long)FIXED_SCALE;
+
+		  if (frac){
+			 int digits = FIXED_DECIMALS;
+			 while (frac % 10 == 0){
+				frac /= 10;
+				--digits;
+			 }
+			 while (digits--){
+				*--runner = (json_char)(frac % 10) + JSON_TEXT('0');
+				frac /= 10;
+			 }
+			 *--runner = JSON_TEXT('.');
+		  }
+		  do {
+			 *--runner = (json_char)(whole % 10) + JSON_TEXT('0');
+		  } while(whole /= 10);
+
+		  //printf keeps the sign of numbers that round to zero
+		  if (negative){
+			 *--runner = JSON_TEXT('-');
+		  }
+		  result.assign(runner);
+		  return true;
+	   }
+    #endif
+
     static json_string _ftoa(json_number value) json_nothrow {
 	   #ifndef JSON_LIBRARY
 			//ScopeCoverage(_ftoa_coverage, 6);
@@ -129,6 +191,17 @@ public:
 			 return _itoa<long EXTRA_LONG>((long EXTRA_LONG)value);
 		  }
 
+	   #ifndef JSON_ISO_STRICT
+		  //PixiAnimate: most numbers are small enough to print as a scaled
+		  //integer, see _fixedtoa
+		  if (json_likely(value < FIXED_LIMIT && value > -FIXED_LIMIT)){
+			 json_string result;
+			 if (json_likely(_fixedtoa(value, result))){
+				return result;
+			 }
+		  }
+	   #endif
+
 	   #ifdef JSON_LESS_MEMORY
 		  json_auto<json_char> s(64);
 	   #else
@@ -20,7 +20,22 @@
     var $soundsPath = $("#soundsPath");
     var $libsPath = $("#libsPath");
     var $compactShapes = $("#compactShapes");
+    var $packShapes = $("#packShapes");
+    var $instanceShapes = $("#instanceShapes");
+    var $shapeGrid = $("#shapeGrid");
+    var $pathPrecision = $("#pathPrecision");
+    var $matrixPrecision = $("#matrixPrecision");
+    var $colorPrecision = $("#colorPrecision");
+    var $alphaPrecision = $("#alphaPrecision");
+    var $seekInterval = $("#seekInterval");
+    var $tweenMoves = $("#tweenMoves");
     var $compressJS = $("#compressJS");
+    var $streamData = $("#streamData");
+    var $compilerServer = $("#compilerServer");
+    var $assetCache = $("#assetCache");
+    var $browserPreview = $("#browserPreview");
+    var $profilePublish = $("#profilePublish");
+    var $sizeReport = $("#sizeReport");
     var $outputFormat = $("#outputFormat");
     var $namespace = $("#namespace");
     var $stageName = $("#stageName");
@@ -120,7 +135,16 @@
         {
             // Booleans options
             $compactShapes.checked = ifBoolOr(data[SETTINGS + "CompactShapes"], true);
+            $packShapes.checked = ifBoolOr(data[SETTINGS + "PackShapes"], false);
+            $instanceShapes.checked = ifBoolOr(data[SETTINGS + "InstanceShapes"], false);
+            $tweenMoves.checked = ifBoolOr(data[SETTINGS + "TweenMoves"], false);
             $compressJS.checked = ifBoolOr(data[SETTINGS + "CompressJS"], true);
+            $streamData.checked = ifBoolOr(data[SETTINGS + "StreamData"], false);
+            $compilerServer.checked = ifBoolOr(data[SETTINGS + "CompilerServer"], false);
+            $assetCache.checked = ifBoolOr(data[SETTINGS + "AssetCache"], false);
+            $browserPreview.checked = ifBoolOr(data[SETTINGS + "BrowserPreview"], false);
+            $profilePublish.checked = ifBoolOr(data[SETTINGS + "ProfilePublish"], false);
+            $sizeReport.checked = ifBoolOr(data[SETTINGS + "SizeReport"], false);
             $html.checked = ifBoolOr(data[SETTINGS + "HTML"], true);
             $libs.checked = ifBoolOr(data[SETTINGS + "Libs"], true);
             $images.checked = ifBoolOr(data[SETTINGS + "Images"], true);
@@ -143,6 +167,12 @@
             $stageName.value = data[SETTINGS + "StageName"];
             $spritesheetSize.value = data[SETTINGS + "SpritesheetSize"] || 1024;
             $spritesheetScale.value = data[SETTINGS + "SpritesheetScale"] || 1.0;
+            $shapeGrid.value = data[SETTINGS + "ShapeGrid"] || "0";
+            $pathPrecision.value = data[SETTINGS + "PathPrecision"] || "2";
+            $matrixPrecision.value = data[SETTINGS + "MatrixPrecision"] || "6";
+            $colorPrecision.value = data[SETTINGS + "ColorPrecision"] || "6";
+            $alphaPrecision.value = data[SETTINGS + "AlphaPrecision"] || "6";
+            $seekInterval.value = data[SETTINGS + "SeekInterval"] || "0";
 
             $outputVersion.value = data[SETTINGS + "OutputVersion"] || "2.0";
 
@@ -182,7 +212,16 @@
 
         // Booleans
         data[SETTINGS + "CompactShapes"] = $compactShapes.checked.toString();
+        data[SETTINGS + "PackShapes"] = $packShapes.checked.toString();
+        data[SETTINGS + "InstanceShapes"] = $instanceShapes.checked.toString();
+        data[SETTINGS + "TweenMoves"] = $tweenMoves.checked.toString();
         data[SETTINGS + "CompressJS"] = $compressJS.checked.toString();
+        data[SETTINGS + "StreamData"] = $streamData.checked.toString();
+        data[SETTINGS + "CompilerServer"] = $compilerServer.checked.toString();
+        data[SETTINGS + "AssetCache"] = $assetCache.checked.toString();
+        data[SETTINGS + "BrowserPreview"] = $browserPreview.checked.toString();
+        data[SETTINGS + "ProfilePublish"] = $profilePublish.checked.toString();
+        data[SETTINGS + "SizeReport"] = $sizeReport.checked.toString();
         data[SETTINGS + "HTML"] = $html.checked.toString();
         data[SETTINGS + "Libs"] = $libs.checked.toString();
         data[SETTINGS + "Images"] = $images.checked.toString();
@@ -200,6 +239,12 @@
         data[SETTINGS + "StageName"] = $stageName.value.toString();
         data[SETTINGS + "SpritesheetSize"] = $spritesheetSize.value.toString();
         data[SETTINGS + "SpritesheetScale"] = $spritesheetScale.value.toString();
+        data[SETTINGS + "ShapeGrid"] = $shapeGrid.value.toString();
+        data[SETTINGS + "PathPrecision"] = $pathPrecision.value.toString();
+        data[SETTINGS + "MatrixPrecision"] = $matrixPrecision.value.toString();
+        data[SETTINGS + "ColorPrecision"] = $colorPrecision.value.toString();
+        data[SETTINGS + "AlphaPrecision"] = $alphaPrecision.value.toString();
+        data[SETTINGS + "SeekInterval"] = $seekInterval.value.toString();
 
         data[SETTINGS + "OutputVersion"] = $outputVersion.value.toString();
         data[SETTINGS + "OutputFormat"] = $outputFormat.value.toString();
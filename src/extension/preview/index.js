@@ -1,6 +1,7 @@
 "use strict";
 
-// Arguments: src, width, height, background, title
+// Arguments: src, width, height, background, title, port
+const net = require('net');
 const minimist = require('minimist');
 const menu = require('./menu');
 const electron = require('electron');
@@ -15,13 +16,45 @@ const argv = minimist(process.argv.slice(2), {
     default: {
         devTools: false,
         title: 'Preview',
-        background: 'fff'
+        background: 'fff',
+        port: 0
     }
 });
 
 // Window to preview in
 let mainWindow = null;
 
+// Reload the preview with the new output
+function reload() {
+    mainWindow.webContents.clearHistory();
+    mainWindow.webContents.send('reload');
+}
+
+// The plugin asks to reload instead of starting another preview,
+// one request line in, one reply line out
+if (argv.port) {
+    net.createServer(function(socket) {
+        let buffer = '';
+        socket.setEncoding('utf8');
+        socket.on('data', function(data) {
+            buffer += data;
+            if (buffer.indexOf('\n') < 0) {
+                return;
+            }
+            const request = buffer.split('\n')[0].trim();
+            if (request === 'reload' && mainWindow) {
+                reload();
+                mainWindow.show();
+                socket.end('ok\n');
+            }
+            else {
+                socket.end('error ' + request + '\n');
+            }
+        });
+        socket.on('error', function() {});
+    }).listen(argv.port, '127.0.0.1');
+}
+
 // Quit when all windows are closed.
 app.on('window-all-closed', function() {
     app.quit();
@@ -86,10 +119,7 @@ app.on('ready', function() {
             toggleDevTools: function() {
                 mainWindow.webContents.send('toggle-dev-tools');
             },
-            reload: function() {
-                mainWindow.webContents.clearHistory();
-                mainWindow.webContents.send('reload');
-            },
+            reload: reload,
             actualSize: function() {
                 mainWindow.setContentSize(argv.width, argv.height, true);
             },
@@ -9,6 +9,150 @@ const Stage = require('./items/Stage');
 const Graphic = require('./items/Graphic');
 const Sound = require('./items/Sound');
 const TimelineTween = require('./data/TimelineTweens');
+const Matrix = require('./data/Matrix');
+
+/**
+ * The matrix of an instance placed without a transform
+ * @property {Object} IDENTITY
+ * @private
+ */
+const IDENTITY = { a: 1, b: 0, c: 0, d: 1, tx: 0, ty: 0 };
+
+/**
+ * Move commands only have the matrix components that changed since the
+ * instance's last Place or Move, fill in the rest. A Move with a tweenStart
+ * ends a straight run whose inside Moves were left out by the exporter.
+ * @method expandMoves
+ * @private
+ * @param {Object} timelineData The timeline data
+ * @return {Array} The runs, with instanceId, start, end, startTransform and endTransform
+ */
+function expandMoves(timelineData)
+{
+    const transforms = {};
+    const runs = [];
+
+    for (const frame of timelineData.frames || [])
+    {
+        for (const command of frame.commands || [])
+        {
+            if (command.type === 'Place')
+            {
+                transforms[command.instanceId] = command.transform;
+            }
+            else if (command.type === 'Move')
+            {
+                const last = transforms[command.instanceId] || IDENTITY;
+                command.transform = Object.assign({}, last, command.transform);
+                transforms[command.instanceId] = command.transform;
+
+                if (command.tweenStart !== undefined)
+                {
+                    runs.push({
+                        instanceId: command.instanceId,
+                        start: command.tweenStart,
+                        end: frame.frame,
+                        startTransform: last,
+                        endTransform: command.transform
+                    });
+                    delete command.tweenStart;
+                }
+            }
+            else if (command.type === 'Remove')
+            {
+                delete transforms[command.instanceId];
+            }
+        }
+    }
+    return runs;
+}
+
+/**
+ * Match the straight runs of a timeline as linear tweens
+ * @method addRunTweens
+ * @private
+ * @param {Library} library The library
+ * @param {String} timelineName The name of the timeline
+ * @param {Array} runs The runs from expandMoves
+ */
+function addRunTweens(library, timelineName, runs)
+{
+    let timelineTweens = library.timelineTweensById[timelineName];
+    if (!timelineTweens)
+    {
+        timelineTweens = new TimelineTween({ timelineName: timelineName, tweens: [] });
+        library.timelineTweensById[timelineName] = timelineTweens;
+    }
+
+    for (const run of runs)
+    {
+        const start = new Matrix(run.startTransform);
+        const end = new Matrix(run.endTransform);
+        const data = {
+            start: run.start,
+            end: run.end,
+            startTransform: run.startTransform
+        };
+        // Only position and scale change along a run
+        for (const prop of ['x', 'y', 'scaleX', 'scaleY'])
+        {
+            if (start[prop] !== end[prop])
+            {
+                data[prop] = {
+                    start: start[prop],
+                    end: end[prop],
+                    easeType: 'classic',
+                    easeStrength: 0
+                };
+            }
+        }
+        timelineTweens.addTween(data);
+    }
+}
+
+/**
+ * Without tweens in the output, put back the Moves inside the straight runs
+ * @method interpolateRuns
+ * @private
+ * @param {Object} timelineData The timeline data
+ * @param {Array} runs The runs from expandMoves
+ */
+function interpolateRuns(timelineData, runs)
+{
+    const frames = {};
+    for (const frame of timelineData.frames)
+    {
+        frames[frame.frame] = frame;
+    }
+
+    for (const run of runs)
+    {
+        for (let f = run.start + 1; f < run.end; f++)
+        {
+            const t = (f - run.start) / (run.end - run.start);
+            const transform = {};
+            for (const key in IDENTITY)
+            {
+                const start = run.startTransform[key];
+                transform[key] = start + (run.endTransform[key] - start) * t;
+            }
+
+            let frame = frames[f];
+            if (!frame)
+            {
+                frame = frames[f] = { frame: f };
+                timelineData.frames.push(frame);
+            }
+            frame.commands = frame.commands || [];
+            frame.commands.push({
+                type: 'Move',
+                instanceId: run.instanceId,
+                transform: transform
+            });
+        }
+    }
+    timelineData.frames.sort((a, b) => a.frame - b.frame);
+}
 
 /**
  * Handle the converting of data assets to typed objects
@@ -78,6 +222,24 @@ const Library = function(data, doTweens)
      */
     this.meta = data._meta;
 
+    /**
+     * The fill styles shared by all shapes, referenced by index
+     * @property {Array} fillStyles
+     */
+    this.fillStyles = data.FillStyles || [];
+
+    /**
+     * The stroke styles shared by all shapes, referenced by index
+     * @property {Array} strokeStyles
+     */
+    this.strokeStyles = data.StrokeStyles || [];
+
+    /**
+     * The gradients shared by all fill styles, referenced by index
+     * @property {Array} gradients
+     */
+    this.gradients = data.Gradients || [];
+
     /**
      * If there are non-animated display containers
      * @property {Boolean} hasContainer
@@ -96,10 +258,16 @@ const Library = function(data, doTweens)
     });
 
     // Convert the shapes
-    data.Shapes.forEach(function(shapeData, id)
+    data.Shapes.forEach(function(shapeData)
     {
+        // Duplicate shape, reuse the first one exported
+        if (shapeData.alias !== undefined)
+        {
+            map[shapeData.assetId] = map[shapeData.alias];
+            return;
+        }
         const shape = new Shape(library, shapeData);
-        shape.id = id;
+        shape.id = shapes.length;
         shapes.push(shape);
         map[shape.assetId] = shape;
     });
@@ -158,6 +326,19 @@ const Library = function(data, doTweens)
     {
         let timeline;
 
+        const runs = expandMoves(timelineData);
+        if (runs.length)
+        {
+            if (doTweens)
+            {
+                addRunTweens(library, timelineData.name, runs);
+            }
+            else
+            {
+                interpolateRuns(timelineData, runs);
+            }
+        }
+
         if (timelineData.totalFrames <= 1 && timelineData.type != Timeline.STAGE)
         {
             self.hasContainer = true;
@@ -240,6 +421,10 @@ p.destroy = function()
     this.bitmaps.length = 0;
     this.bitmaps = null;
 
+    this.fillStyles = null;
+    this.strokeStyles = null;
+    this.gradients = null;
+
     this._mapById = null;
 };
 
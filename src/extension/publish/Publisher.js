@@ -15,7 +15,7 @@ const globalLog = require('./globalLog');
  * The application to publish the JSON data to JS output buffer
  * @class Publisher
  */
-let Publisher = function(dataFile, compress, debug, assetsPath)
+let Publisher = function(dataFile, compress, debug, assetsPath, stdin)
 {
     // Change the current directory
     process.chdir(path.dirname(dataFile));
@@ -26,15 +26,26 @@ let Publisher = function(dataFile, compress, debug, assetsPath)
      */
     this._dataFile = dataFile;
 
+    /**
+     * If the data was piped to standard input, there is no file to delete
+     * @property {Boolean} _stdin
+     * @private
+     */
+    this._stdin = !!stdin;
+
     /**
      * The data published from Flash
      * @property {Object} _data
      * @private
      */
-    this._data = JSON.parse(fs.readFileSync(dataFile, "utf8"));
+    this._data = JSON.parse(fs.readFileSync(this._stdin ? 0 : dataFile, "utf8"));
 
-    let outputFile = path.join(process.cwd(), this._data._meta.outputFile + 'on');
-    fs.writeFileSync(outputFile, JSON.stringify(this._data, null, 4));
+    // Streamed data is only written out for debugging
+    if (!this._stdin || debug)
+    {
+        let outputFile = path.join(process.cwd(), this._data._meta.outputFile + 'on');
+        fs.writeFileSync(outputFile, JSON.stringify(this._data, null, 4));
+    }
 
     // override the compress
     if (compress)
@@ -167,7 +178,7 @@ p.exportAssets = function(done)
  */
 p.destroy = function()
 {
-    if (!this.debug)
+    if (!this.debug && !this._stdin)
     {
         fs.unlinkSync(this._dataFile);
     }
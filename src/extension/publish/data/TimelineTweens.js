@@ -24,16 +24,26 @@ const TimelineTween = function (timeline) {
 
     for (const data of timeline.tweens)
     {
-        const tween = new Tween(data);
-        if (!this.tweensByStartFrame[tween.startFrame])
-        {
-            this.tweensByStartFrame[tween.startFrame] = [];
-        }
-        this.tweensByStartFrame[tween.startFrame].push(tween);
+        this.addTween(data);
     }
 };
 
 // Extends the prototype
-// const p = TimelineTween.prototype;
+const p = TimelineTween.prototype;
+
+/**
+ * Add a tween to match against the timeline's instances
+ * @method addTween
+ * @param {Object} data The data for an individual tween.
+ */
+p.addTween = function(data)
+{
+    const tween = new Tween(data);
+    if (!this.tweensByStartFrame[tween.startFrame])
+    {
+        this.tweensByStartFrame[tween.startFrame] = [];
+    }
+    this.tweensByStartFrame[tween.startFrame].push(tween);
+};
 
 module.exports = TimelineTween;
\ No newline at end of file
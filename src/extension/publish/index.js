@@ -6,12 +6,15 @@ const minimist = require('minimist');
 const path = require('path');
 const semver = require('semver');
 const argv = minimist(process.argv.slice(2), {
-    boolean: ['debug', 'compress', 'perf'],
+    boolean: ['debug', 'compress', 'perf', 'stdin', 'server'],
     string: ['assets', 'src'],
     default: {
         debug: false,
         compress: false,
-        perf: false
+        perf: false,
+        stdin: false,
+        server: false,
+        port: 0
     }
 });
 
@@ -22,6 +25,10 @@ app.on('ready', function() {
         alert("Must use Electron v1.8.2 or greater. Install using 'npm install -g electron-prebuilt'");
         quit();
     }
+    else if (argv.server)
+    {
+        serve(argv.port);
+    }
     else if (!argv.src)
     {
         alert("Source must be path to data output.");
@@ -34,43 +41,139 @@ app.on('ready', function() {
     }
     else
     {
-        // For measuring performance
-        const startTime = process.hrtime()[1];
+        publish(argv.src, argv.debug, argv.stdin, (err) => {
+            if (err) {
+                alert(err);
+            }
+            quit();
+        });
+    }
+});
+
+/**
+ * Publish a data file
+ * @param {string} src Path to the data file
+ * @param {Boolean} debug Don't delete the source file
+ * @param {Boolean} stdin If the data is piped in, src only names it
+ * @param {Function} done Called with an error or nothing
+ */
+function publish(src, debug, stdin, done)
+{
+    // For measuring performance
+    const startTime = process.hrtime()[1];
 
-        // Include classes
-        const Publisher = require('./Publisher');
-        const DataUtils = require('./utils/DataUtils');
+    // Include classes
+    const Publisher = require('./Publisher');
+    const DataUtils = require('./utils/DataUtils');
 
+    let publisher;
+    try
+    {
         // Create a new publisher
-        const publisher = new Publisher(
-            argv.src, // path to the javascript file
+        publisher = new Publisher(
+            src, // path to the javascript file
             argv.compress, // If the output should be compressed
-            argv.debug, // Don't delete the source file
-            argv.assets || __dirname
+            debug, // Don't delete the source file
+            argv.assets || __dirname,
+            stdin
         );
+    }
+    catch(e)
+    {
+        return done(e);
+    }
 
-        // Allow override of snippets for debugging purposes
-        publisher.renderer.snippetsPath = path.resolve(
-            argv.assets || __dirname, 'snippets'
-        );
+    // Allow override of snippets for debugging purposes
+    publisher.renderer.snippetsPath = path.resolve(
+        argv.assets || __dirname, 'snippets'
+    );
 
-        publisher.run((err) => {
-            if (err) {
-                alert(err);
-                return quit();
+    publisher.run((err) => {
+        if (err) {
+            return done(err);
+        }
+        // Output performance information
+        if (argv.perf)
+        {
+            let executionTime = DataUtils.toPrecision(
+                (process.hrtime()[1] - startTime) / Math.pow(10, 9), 4
+            );
+            console.log(`\nExecuted in ${executionTime} seconds\n`);
+        }
+        done();
+    });
+}
+
+/**
+ * Keep the compiler running and publish on request, so the plugin only
+ * pays for starting Electron once. Each connection sends one line, either
+ * "ping" or a JSON request {src, debug}, and gets one line back: "pong",
+ * "ok" or "error" followed by the message.
+ * @param {int} port Local port to listen on
+ */
+function serve(port)
+{
+    const net = require('net');
+    const globalLog = require('./globalLog');
+
+    // Busy publishing, requests wait their turn
+    let queue = Promise.resolve();
+
+    const server = net.createServer((socket) => {
+        let line = "";
+        socket.setEncoding('utf8');
+        socket.on('error', () => {});
+        socket.on('data', (chunk) => {
+            line += chunk;
+            const end = line.indexOf('\n');
+            if (end < 0) {
+                return;
             }
-            // Output performance information
-            if (argv.perf)
-            {
-                let executionTime = DataUtils.toPrecision(
-                    (process.hrtime()[1] - startTime) / Math.pow(10, 9), 4
-                );
-                console.log(`\nExecuted in ${executionTime} seconds\n`);
+            const request = line.substr(0, end);
+            line = "";
+
+            if (request === 'ping') {
+                return socket.end('pong\n');
             }
-            quit();
+
+            queue = queue.then(() => new Promise((resolve) => {
+                let options;
+                try {
+                    options = JSON.parse(request);
+                }
+                catch(e) {
+                    socket.end('error Request is not valid JSON\n');
+                    return resolve();
+                }
+
+                // The log is kept per publish
+                globalLog.length = 0;
+
+                publish(options.src, !!options.debug, false, (err) => {
+                    if (err) {
+                        const message = options.debug && err instanceof Error ? err.stack : String(err);
+                        socket.end('error ' + message.replace(/\n/g, ' ') + '\n');
+                    }
+                    else {
+                        socket.end('ok\n');
+                    }
+                    resolve();
+                });
+            }));
         });
-    }
-});
+    });
+
+    server.on('error', (err) => {
+        console.error(err);
+        quit();
+    });
+    server.listen(port, '127.0.0.1');
+
+    // The plugin holds our input open, quit when it goes away
+    process.stdin.on('end', quit);
+    process.stdin.on('error', quit);
+    process.stdin.resume();
+}
 
 function quit() {
     app.quit();
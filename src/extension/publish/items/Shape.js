@@ -32,6 +32,22 @@ const Shape = function(library, data)
     for(let j = 0, len = this.paths.length; j < len; j++)
     {
         let path = this.paths[j];
+
+        // Styles are shared by the document and referenced by index
+        if (path.fill !== undefined)
+        {
+            Object.assign(path, library.fillStyles[path.fill]);
+
+            if (path.gradient !== undefined)
+            {
+                Object.assign(path, library.gradients[path.gradient]);
+            }
+        }
+        if (path.strokeStyle !== undefined)
+        {
+            Object.assign(path, library.strokeStyles[path.strokeStyle]);
+        }
+
         let gradient = path.radialGradient || path.linearGradient;
 
         // Adding a stroke
@@ -67,6 +83,17 @@ const Shape = function(library, data)
             draw.push("f", this.toColor(path.color), path.alpha);
         }
 
+        // Unpack shapes published with the packed encoding
+        if (typeof path.d == "string")
+        {
+            path.d = DataUtils.decodePath(path.d, library.meta.shapeGrid);
+        }
+        // Shapes quantised to a grid are written as deltas
+        else if (library.meta.shapeGrid)
+        {
+            DataUtils.undeltaPath(path.d, library.meta.shapeGrid);
+        }
+
         path.d.forEach(function(command, k, commands)
         {
             if (typeof command == "number")
@@ -20,6 +20,97 @@ var DataUtils = {
         return Math.round(val * num) / num;
     },
 
+    /**
+     * The drawing commands of a packed path, indexed by opcode
+     * @property {Array} PATH_COMMANDS
+     * @static
+     * @private
+     */
+    PATH_COMMANDS: [
+        ["m", 2], // moveTo
+        ["l", 2], // lineTo
+        ["q", 4], // quadraticCurveTo
+        ["cp", 0], // closePath
+        ["bh", 0], // beginHole
+        ["eh", 0] // endHole
+    ],
+
+    /**
+     * Decode a packed path into the drawing commands, the packed path is
+     * each command as a byte followed by its points as little-endian Float32,
+     * or as zig-zag varint grid deltas if the shapes are quantised
+     * @method decodePath
+     * @static
+     * @param {String} packed Base64 packed path
+     * @param {Number} [grid=0] The size of the quantised grid in pixels
+     * @return {Array} The drawing commands
+     */
+    decodePath: function(packed, grid)
+    {
+        const buffer = Buffer.from(packed, 'base64');
+        const commands = [];
+        let offset = 0;
+        while (offset < buffer.length)
+        {
+            const command = this.PATH_COMMANDS[buffer[offset++]];
+            if (!command)
+            {
+                throw new Error(`Invalid packed path command ${buffer[offset - 1]}`);
+            }
+            commands.push(command[0]);
+            for (let i = 0; i < command[1]; i++)
+            {
+                if (grid)
+                {
+                    let bits = 0;
+                    let shift = 0;
+                    let byte;
+                    do
+                    {
+                        byte = buffer[offset++];
+                        bits += (byte & 0x7f) * Math.pow(2, shift);
+                        shift += 7;
+                    }
+                    while (byte & 0x80);
+                    // undo the zig-zag
+                    commands.push(bits % 2 ? -(bits + 1) / 2 : bits / 2);
+                }
+                else
+                {
+                    commands.push(buffer.readFloatLE(offset));
+                    offset += 4;
+                }
+            }
+        }
+        return grid ? this.undeltaPath(commands, grid) : commands;
+    },
+
+    /**
+     * Convert the points of a quantised path from grid deltas back
+     * into absolute pixel positions, in place
+     * @method undeltaPath
+     * @static
+     * @param {Array} commands The drawing commands
+     * @param {Number} grid The size of the quantised grid in pixels
+     * @return {Array} The drawing commands
+     */
+    undeltaPath: function(commands, grid)
+    {
+        // The x and y values alternate, keep a running total of each
+        const last = [0, 0];
+        let axis = 0;
+        for (let i = 0; i < commands.length; i++)
+        {
+            if (typeof commands[i] == "number")
+            {
+                last[axis] += commands[i];
+                commands[i] = last[axis] * grid;
+                axis = 1 - axis;
+            }
+        }
+        return commands;
+    },
+
     /**
      * Replace the key names with un-quoted strings
      * @method stringifySimple